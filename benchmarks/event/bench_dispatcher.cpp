@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <map>
+#include <vector>
+#ifdef GTPROXY_BENCHMARK_EVENTPP
+#include <eventpp/eventdispatcher.h>
+#endif
+
+#include "event/event.hpp"
+
+namespace {
+#ifdef GTPROXY_BENCHMARK_EVENTPP
+// The eventpp backed dispatcher PriorityEventDispatcher replaced, kept here as the baseline
+class EventppDispatcher {
+public:
+    struct Policies {
+        static event::Type getEvent(const event::Event& e) { return e.type; }
+        static bool canContinueInvoking(const event::Event& e) { return !e.canceled; }
+    };
+
+    using Base = eventpp::EventDispatcher<event::Type, void(const event::Event&), Policies>;
+    using Handle = Base::Handle;
+    using Callback = std::function<void(const event::Event&)>;
+
+    Handle appendListener(const event::Type event, const Callback& callback, const int8_t priority = event::Priority::Normal)
+    {
+        auto& entries = handles_[event];
+
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->priority > priority) {
+                auto handle = dispatcher_.insertListener(event, callback, it->handle);
+                entries.insert(it, { priority, handle });
+                return handle;
+            }
+        }
+
+        auto handle = dispatcher_.appendListener(event, callback);
+        entries.push_back({ priority, handle });
+        return handle;
+    }
+
+    bool removeListener(const event::Type event, const Handle& handle)
+    {
+        if (const auto it = handles_.find(event); it != handles_.end()) {
+            std::erase_if(it->second, [&handle](const PriorityEntry& e) { return e.handle == handle; });
+        }
+
+        return dispatcher_.removeListener(event, handle);
+    }
+
+    void dispatch(const event::Event& e) const
+    {
+        dispatcher_.dispatch(e);
+    }
+
+private:
+    struct PriorityEntry {
+        int8_t priority;
+        Handle handle;
+    };
+
+    Base dispatcher_;
+    std::map<event::Type, std::vector<PriorityEntry>> handles_;
+};
+#endif
+
+constexpr std::array PACKET_IDS{
+    packet::PacketId::ServerHello,
+    packet::PacketId::Quit,
+    packet::PacketId::QuitToExit,
+    packet::PacketId::JoinRequest,
+    packet::PacketId::ValidateWorld,
+    packet::PacketId::Input,
+    packet::PacketId::Log,
+    packet::PacketId::OnNameChanged,
+    packet::PacketId::OnChangeSkin,
+    packet::PacketId::Disconnect,
+    packet::PacketId::TileChangeRequest,
+    packet::PacketId::SendMapData,
+    packet::PacketId::SendTileUpdateData,
+    packet::PacketId::SendItemDatabaseData,
+    packet::PacketId::SendInventoryState,
+    packet::PacketId::ModifyItemInventory,
+    packet::PacketId::ItemChangeObject,
+    packet::PacketId::OnSendToServer,
+    packet::PacketId::OnSpawn,
+    packet::PacketId::OnRemove,
+};
+
+// Roughly what a shard subscribes, the script bridge on every type plus the built-in handlers
+template <typename Dispatcher>
+void subscribe_like_shard(Dispatcher& dispatcher, int& calls)
+{
+    const auto listener = [&calls](const event::Event&) { ++calls; };
+
+    for (const auto type : { event::Type::ClientConnect, event::Type::ClientDisconnect, event::Type::ServerConnect,
+                             event::Type::ServerDisconnect, event::Type::ClientBoundPacket, event::Type::ServerBoundPacket }) {
+        dispatcher.appendListener(type, listener, event::Priority::FairlyHigh);
+        dispatcher.appendListener(type, listener);
+    }
+
+    for (const auto id : PACKET_IDS) {
+        dispatcher.appendListener(event::packet_event_type(id), listener, event::Priority::FairlyHigh);
+        dispatcher.appendListener(event::packet_event_type(id), listener);
+    }
+}
+
+template <typename Dispatcher>
+void BM_Dispatch(benchmark::State& state)
+{
+    Dispatcher dispatcher{};
+    int calls{ 0 };
+    subscribe_like_shard(dispatcher, calls);
+
+    const event::RawPacketEvent raw{ event::Type::ServerBoundPacket, {} };
+    const event::TypedPacketEvent<packet::PacketId::OnSpawn> on_spawn{ event::Direction::ClientBound, nullptr };
+    const event::TypedPacketEvent<packet::PacketId::Input> input{ event::Direction::ServerBound, nullptr };
+
+    for (auto _ : state) {
+        dispatcher.dispatch(raw);
+        dispatcher.dispatch(on_spawn);
+        dispatcher.dispatch(input);
+    }
+
+    benchmark::DoNotOptimize(calls);
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+
+template <typename Dispatcher>
+void BM_SubscribeUnsubscribe(benchmark::State& state)
+{
+    Dispatcher dispatcher{};
+    int calls{ 0 };
+    subscribe_like_shard(dispatcher, calls);
+
+    const auto type{ event::packet_event_type(packet::PacketId::OnSpawn) };
+    for (auto _ : state) {
+        const auto handle{ dispatcher.appendListener(type, [](const event::Event&) { }, event::Priority::FairlyLow) };
+        dispatcher.removeListener(type, handle);
+    }
+}
+}
+
+#ifdef GTPROXY_BENCHMARK_EVENTPP
+BENCHMARK_TEMPLATE(BM_Dispatch, EventppDispatcher);
+BENCHMARK_TEMPLATE(BM_SubscribeUnsubscribe, EventppDispatcher);
+#endif
+BENCHMARK_TEMPLATE(BM_Dispatch, event::PriorityEventDispatcher);
+BENCHMARK_TEMPLATE(BM_SubscribeUnsubscribe, event::PriorityEventDispatcher);
@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "packet/packet_id.hpp"
+#include "utils/text_parse.hpp"
+
+using namespace packet;
+
+namespace {
+// The std::regex classification text_action::match replaced, kept here as the baseline
+struct TextRegexPattern {
+    std::regex compiled;
+    PacketId id;
+};
+
+const std::vector<TextRegexPattern>& regex_patterns()
+{
+    static const std::vector<TextRegexPattern> patterns{
+        { std::regex{ R"(^action\|quit$)", std::regex::optimize }, PacketId::Quit },
+        { std::regex{ R"(^action\|quit_to_exit$)", std::regex::optimize }, PacketId::QuitToExit },
+        { std::regex{ R"(^action\|join_request$)", std::regex::optimize }, PacketId::JoinRequest },
+        { std::regex{ R"(^action\|validate_world$)", std::regex::optimize }, PacketId::ValidateWorld },
+        { std::regex{ R"(^action\|input)", std::regex::optimize }, PacketId::Input },
+        { std::regex{ R"(^action\|log$)", std::regex::optimize }, PacketId::Log },
+    };
+
+    return patterns;
+}
+
+PacketId regex_match(const utils::TextParse& text_parse)
+{
+    const std::string raw{ text_parse.get_raw() };
+    for (const auto& [compiled, id] : regex_patterns()) {
+        if (std::regex_search(raw, compiled)) {
+            return id;
+        }
+    }
+
+    return PacketId::Unknown;
+}
+
+const std::vector<std::string>& messages()
+{
+    static const std::vector<std::string> texts{
+        "action|input\n|text|hello there, anyone selling world locks?",
+        "action|join_request\nname|START\ninvitedWorld|0",
+        "action|quit_to_exit",
+        "action|dialog_return\ndialog_name|popup\nnetID|1|\nbuttonClicked|trade",
+        "action|log\nmsg|`4Oops:`` Too many people logging in at once.",
+    };
+
+    return texts;
+}
+
+void BM_TextActionRegex(benchmark::State& state)
+{
+    std::vector<utils::TextParse> parsed{};
+    for (const auto& text : messages()) {
+        parsed.emplace_back(text);
+    }
+
+    for (auto _ : state) {
+        for (const auto& text_parse : parsed) {
+            benchmark::DoNotOptimize(regex_match(text_parse));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(parsed.size()));
+}
+
+void BM_TextActionMatcher(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (const auto& text : messages()) {
+            benchmark::DoNotOptimize(text_action::match(text));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(messages().size()));
+}
+}
+
+BENCHMARK(BM_TextActionRegex);
+BENCHMARK(BM_TextActionMatcher);
@@ -5,10 +5,11 @@ from conan.tools.cmake import CMake, cmake_layout
 class GTProxyRecipe(ConanFile):
     settings = 'os', 'compiler', 'build_type', 'arch'
     generators = 'CMakeToolchain', 'CMakeDeps'
+    options = {'with_benchmarks': [True, False]}
+    default_options = {'with_benchmarks': False}
 
     def requirements(self):
         # self.requires('cpp-httplib/[~0.29]')
-        self.requires('eventpp/[~0.1]')
         self.requires('fmt/12.0.0')
         self.requires('glaze/[~6.2]')
         self.requires('glm/[~0.9.9]')
@@ -21,6 +22,11 @@ class GTProxyRecipe(ConanFile):
         self.requires('sol2/[~3.5]')
         self.requires('zlib/1.3.1')
 
+        if self.options.with_benchmarks:
+            self.requires('benchmark/[~1.9]')
+            # Baseline for the event dispatcher benchmark
+            self.requires('eventpp/[~0.1]')
+
     def layout(self):
         cmake_layout(self)
 
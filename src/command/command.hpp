@@ -7,8 +7,7 @@
 
 #include "../core/scheduler.hpp"
 #include "../event/event.hpp"
-#include "../network/client.hpp"
-#include "../network/server.hpp"
+#include "../network/session.hpp"
 
 namespace command {
 class CommandRegistry;
@@ -22,7 +21,9 @@ enum class Result {
 struct Context {
     std::vector<std::string> args;
     std::string raw_input;
-    network::Server& server;
+    network::Session& session;
+    // Connection to the Growtopia client and to the Growtopia server of the session
+    network::PeerConnection& server;
     network::Client& client;
     event::Dispatcher& dispatcher;
     std::shared_ptr<core::Scheduler> scheduler;
@@ -8,7 +8,9 @@
 #include "commands/debug_command.hpp"
 #include "commands/exit_command.hpp"
 #include "commands/help_command.hpp"
+#include "commands/net_stats_command.hpp"
 #include "commands/nick_command.hpp"
+#include "commands/profile_command.hpp"
 #include "commands/proxy_command.hpp"
 #include "commands/skin_command.hpp"
 #include "commands/warp_command.hpp"
@@ -21,22 +23,19 @@ namespace {
 CommandHandler::CommandHandler(
     core::Config& config,
     event::Dispatcher& dispatcher,
-    std::shared_ptr<core::Scheduler> scheduler,
-    network::Server& server,
-    network::Client& client
+    std::shared_ptr<core::Scheduler> scheduler
 )
     : config_{ config }
     , dispatcher_{ dispatcher }
     , scheduler_{ std::move(scheduler) }
-    , server_{ server }
-    , client_{ client }
 {
     registry_.set_prefix(config_.get_command_config().prefix);
     register_default_commands();
 
-    listener_handle_ = dispatcher_.prependListener(
-        input_event_type,
-        [this](const event::Event& e) { on_text_packet(e); }
+    listener_handle_ = dispatcher_.on<packet::PacketId::Input>(
+        [this](const event::TypedPacketEvent<packet::PacketId::Input>& evt) { on_text_packet(evt); },
+        event::Priority::Highest,
+        "CommandHandler::on_text_packet"
     );
 
     spdlog::info("Command handler initialized with prefix '{}'", registry_.prefix());
@@ -56,24 +55,25 @@ void CommandHandler::register_default_commands()
     registry_.add(std::make_unique<SkinCommand>());
     registry_.add(std::make_unique<HelpCommand>());
     registry_.add(std::make_unique<DebugCommand>());
+    registry_.add(std::make_unique<ProfileCommand>());
+    registry_.add(std::make_unique<NetStatsCommand>());
 }
 
-void CommandHandler::on_text_packet(const event::Event& e)
+void CommandHandler::on_text_packet(const event::TypedPacketEvent<packet::PacketId::Input>& evt)
 {
-    const auto* evt = dynamic_cast<const event::TypedPacketEvent<packet::PacketId::Input>*>(&e);
-    if (!evt) {
+    if (!evt.session) {
         return;
     }
 
-    const auto input_pkt{ evt->get<packet::message::Input>() };
+    const auto input_pkt{ evt.get<packet::message::Input>() };
     if (!input_pkt) {
         return;
     }
 
     const std::string& text = input_pkt->text;
-    if (registry_.execute(text, server_, client_, dispatcher_, scheduler_)) {
+    if (registry_.execute(text, *evt.session, dispatcher_, scheduler_)) {
         spdlog::info("Command handler executed successfully");
-        evt->cancel();
+        evt.cancel();
     }
 }
 }
@@ -3,8 +3,6 @@
 #include "../core/config.hpp"
 #include "../core/scheduler.hpp"
 #include "../event/event.hpp"
-#include "../network/client.hpp"
-#include "../network/server.hpp"
 
 namespace command {
 class CommandHandler {
@@ -12,9 +10,7 @@ public:
     CommandHandler(
         core::Config& config,
         event::Dispatcher& dispatcher,
-        std::shared_ptr<core::Scheduler> scheduler,
-        network::Server& server,
-        network::Client& client
+        std::shared_ptr<core::Scheduler> scheduler
     );
     ~CommandHandler();
 
@@ -24,14 +20,12 @@ public:
 private:
     void register_default_commands();
 
-    void on_text_packet(const event::Event& e);
+    void on_text_packet(const event::TypedPacketEvent<packet::PacketId::Input>& evt);
 
 private:
     core::Config& config_;
     event::Dispatcher& dispatcher_;
     std::shared_ptr<core::Scheduler> scheduler_;
-    network::Server& server_;
-    network::Client& client_;
 
     CommandRegistry registry_;
     event::Dispatcher::Handle listener_handle_;
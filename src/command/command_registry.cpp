@@ -36,8 +36,7 @@ bool CommandRegistry::is_command(std::string_view input) const
 
 bool CommandRegistry::execute(
     std::string_view input,
-    network::Server& server,
-    network::Client& client,
+    network::Session& session,
     event::Dispatcher& dispatcher,
     std::shared_ptr<core::Scheduler> scheduler)
 {
@@ -58,8 +57,9 @@ bool CommandRegistry::execute(
     const Context ctx{
         std::move(args),
         std::string(input),
-        server,
-        client,
+        session,
+        session.downstream(),
+        session.upstream(),
         dispatcher,
         std::move(scheduler),
         *this
@@ -32,8 +32,7 @@ public:
 
     [[nodiscard]] bool execute(
         std::string_view input,
-        network::Server& server,
-        network::Client& client,
+        network::Session& session,
         event::Dispatcher& dispatcher,
         std::shared_ptr<core::Scheduler> scheduler
     );
@@ -28,7 +28,7 @@ public:
         const std::string& sub_cmd{ ctx.args[0] };
 
         if (sub_cmd == "player") {
-            const auto& world{ world::World::instance() };
+            const auto& world{ ctx.session.world() };
             const auto& players = world.get_players();
 
             if (ctx.args.size() < 2) {
@@ -73,7 +73,7 @@ public:
         }
 
         if (sub_cmd == "world") {
-            auto& world{ world::World::instance() };
+            auto& world{ ctx.session.world() };
             auto& tile_map{ world.get_tile_map() };
             auto& object_map{ world.get_object_map() };
 
@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <fmt/format.h>
+
+#include "../command.hpp"
+#include "../../network/traffic_metrics.hpp"
+#include "../../packet/packet_helper.hpp"
+#include "../../packet/message/chat.hpp"
+
+namespace command {
+class NetStatsCommand final : public ICommand {
+public:
+    [[nodiscard]] std::string_view name() const override { return "netstats"; }
+    [[nodiscard]] std::string description() const override { return "Show outbound queue, datagram and forward metrics: /netstats [reset]"; }
+
+    Result execute(const Context& ctx) override
+    {
+        auto& metrics{ network::TrafficMetrics::instance() };
+        const std::string sub_cmd{ ctx.args.empty() ? "" : ctx.args[0] };
+
+        if (sub_cmd == "reset") {
+            metrics.reset();
+            send_log(ctx, "Network metrics reset.");
+            return Result::Success;
+        }
+
+        if (!sub_cmd.empty()) {
+            send_log(ctx, "Usage: /netstats [reset]");
+            return Result::InvalidArguments;
+        }
+
+        send_outbound(ctx, "Client-bound", metrics.outbound(event::Direction::ClientBound));
+        send_outbound(ctx, "Server-bound", metrics.outbound(event::Direction::ServerBound));
+        send_datagrams(ctx, "Client-bound", metrics.datagrams(event::Direction::ClientBound));
+        send_datagrams(ctx, "Server-bound", metrics.datagrams(event::Direction::ServerBound));
+        send_forwards(ctx, metrics.forwards());
+        return Result::Success;
+    }
+
+private:
+    static void send_outbound(const Context& ctx, const std::string_view label, const network::OutboundMetrics& metrics)
+    {
+        using us = std::chrono::duration<double, std::micro>;
+
+        const auto snapshot{ metrics.snapshot() };
+        send_log(
+            ctx,
+            fmt::format(
+                "{} queue: {} queued, {} sent, {} dropped, {:.1f} us avg, {:.1f} us max",
+                label,
+                snapshot.depth,
+                snapshot.sent,
+                snapshot.dropped,
+                std::chrono::duration_cast<us>(snapshot.avg_latency()).count(),
+                std::chrono::duration_cast<us>(snapshot.max_latency).count()
+            )
+        );
+    }
+
+    static void send_datagrams(const Context& ctx, const std::string_view label, const network::DatagramMetrics& metrics)
+    {
+        const auto snapshot{ metrics.snapshot() };
+        send_log(
+            ctx,
+            fmt::format(
+                "{} datagrams: {} sent, {:.1f}/s, {:.1f} bytes each",
+                label,
+                snapshot.datagrams,
+                snapshot.per_second(),
+                snapshot.bytes_per_datagram()
+            )
+        );
+    }
+
+    static void send_forwards(const Context& ctx, const network::ForwardMetrics& metrics)
+    {
+        const auto snapshot{ metrics.snapshot() };
+        send_log(
+            ctx,
+            fmt::format(
+                "Forwarded: {} handed off, {} copied because they were still shared",
+                snapshot.handed_off,
+                snapshot.copied
+            )
+        );
+    }
+
+    static void send_log(const Context& ctx, const std::string& msg)
+    {
+        packet::message::Log log_pkt{};
+        log_pkt.msg = msg;
+        packet::PacketHelper::write(log_pkt, ctx.server);
+    }
+};
+}
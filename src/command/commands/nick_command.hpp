@@ -30,7 +30,7 @@ public:
         }
 
         packet::game::OnNameChanged pkt{};
-        pkt.net_id = world::World::instance().get_local_net_id();
+        pkt.net_id = ctx.session.world().get_local_net_id();
         pkt.name = name;
         packet::PacketHelper::write(pkt, ctx.server);
 
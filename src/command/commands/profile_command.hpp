@@ -0,0 +1,142 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <glaze/glaze.hpp>
+#include <magic_enum/magic_enum.hpp>
+
+#include "../command.hpp"
+#include "../../packet/packet_helper.hpp"
+#include "../../packet/packet_registry.hpp"
+#include "../../packet/message/chat.hpp"
+
+namespace command {
+// Row of the JSON dump, one per listener
+struct ListenerProfile {
+    std::string tag;
+    std::string event;
+    int priority;
+    std::uint64_t calls;
+    std::uint64_t cancels;
+    double cancel_rate;
+    double total_ms;
+    double max_ms;
+    double avg_us;
+};
+
+class ProfileCommand final : public ICommand {
+public:
+    static constexpr std::size_t TOP_COUNT{ 10 };
+    static constexpr std::string_view DUMP_PATH{ "profile.json" };
+
+    [[nodiscard]] std::string_view name() const override { return "profile"; }
+    [[nodiscard]] std::string description() const override { return "Profile event listeners: /profile [on|off|reset|dump]"; }
+
+    Result execute(const Context& ctx) override
+    {
+        auto& profiler{ ctx.dispatcher.profiler() };
+        const std::string sub_cmd{ ctx.args.empty() ? "" : ctx.args[0] };
+
+        if (sub_cmd == "on") {
+            profiler.reset();
+            profiler.set_enabled(true);
+            send_log(ctx, "Listener profiling enabled for this shard.");
+            return Result::Success;
+        }
+
+        if (sub_cmd == "off") {
+            profiler.set_enabled(false);
+            send_log(ctx, "Listener profiling disabled.");
+            return Result::Success;
+        }
+
+        if (sub_cmd == "reset") {
+            profiler.reset();
+            send_log(ctx, "Listener profile reset.");
+            return Result::Success;
+        }
+
+        const auto entries{ collect(profiler) };
+
+        if (sub_cmd == "dump") {
+            if (const auto ec = glz::write_file_json<glz::opts{ .prettify = true }>(entries, DUMP_PATH, std::string{})) {
+                send_log(ctx, fmt::format("`4Failed to write {}: ``{}", DUMP_PATH, glz::format_error(ec)));
+                return Result::Failed;
+            }
+
+            send_log(ctx, fmt::format("Wrote {} listener profiles to {}", entries.size(), DUMP_PATH));
+            return Result::Success;
+        }
+
+        if (!sub_cmd.empty()) {
+            send_log(ctx, "Usage: /profile [on|off|reset|dump]");
+            return Result::InvalidArguments;
+        }
+
+        send_log(ctx, fmt::format("Listener profiling is {}", profiler.enabled() ? "`2on``" : "`4off``"));
+        for (std::size_t i{ 0 }; i < entries.size() && i < TOP_COUNT; ++i) {
+            const auto& entry{ entries[i] };
+            if (entry.calls == 0) {
+                break;
+            }
+
+            send_log(
+                ctx,
+                fmt::format(
+                    "{} [{}]: {} calls, {:.3f} ms total, {:.3f} ms max, {:.1f}% canceled",
+                    entry.tag,
+                    entry.event,
+                    entry.calls,
+                    entry.total_ms,
+                    entry.max_ms,
+                    entry.cancel_rate * 100.0
+                )
+            );
+        }
+
+        return Result::Success;
+    }
+
+private:
+    [[nodiscard]] static std::vector<ListenerProfile> collect(const event::DispatchProfiler& profiler)
+    {
+        using ms = std::chrono::duration<double, std::milli>;
+        using us = std::chrono::duration<double, std::micro>;
+
+        std::vector<ListenerProfile> entries{};
+        for (const auto& stats : profiler.snapshot()) {
+            entries.push_back({
+                stats.tag,
+                event_name(stats.type),
+                stats.priority,
+                stats.calls,
+                stats.cancels,
+                stats.cancel_rate(),
+                std::chrono::duration_cast<ms>(stats.total).count(),
+                std::chrono::duration_cast<ms>(stats.max).count(),
+                stats.calls ? std::chrono::duration_cast<us>(stats.total).count() / static_cast<double>(stats.calls) : 0.0
+            });
+        }
+
+        return entries;
+    }
+
+    [[nodiscard]] static std::string event_name(const event::Type type)
+    {
+        if (event::is_packet_event(type)) {
+            return packet::packet_name(event::packet_id_from_type(type));
+        }
+
+        return std::string{ magic_enum::enum_name(type) };
+    }
+
+    static void send_log(const Context& ctx, const std::string& msg)
+    {
+        packet::message::Log log_pkt{};
+        log_pkt.msg = msg;
+        packet::PacketHelper::write(log_pkt, ctx.server);
+    }
+};
+}
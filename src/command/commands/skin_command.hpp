@@ -51,7 +51,7 @@ public:
         }
 
         packet::game::OnChangeSkin pkt{};
-        pkt.net_id = world::World::instance().get_local_net_id();
+        pkt.net_id = ctx.session.world().get_local_net_id();
         pkt.skin_code = skin_code;
         packet::PacketHelper::write(pkt, ctx.server);
 
@@ -35,7 +35,9 @@ public:
             return Result::InvalidArguments;
         }
 
-        ctx.scheduler->cancel_by_tag("warp");
+        // Tagged per session so a warp on one account does not cancel another
+        const auto tag{ fmt::format("warp:{}", ctx.session.id()) };
+        ctx.scheduler->cancel_by_tag(tag);
 
         packet::message::QuitToExit quit_pkt{};
         packet::PacketHelper::write(quit_pkt, ctx.client);
@@ -44,10 +46,12 @@ public:
         log.msg = fmt::format("Warping to {}...", world_name);
         packet::PacketHelper::write(log, ctx.server);
 
-        const auto client{ &ctx.client };
+        // The timer fires on a scheduler thread, the join request goes through the session's inject queue
+        // and is sent by its shard on the next flush. The shard drops it if the upstream is gone by then.
         ctx.scheduler->schedule_delayed(
-            [client, &world_name] {
-                if (!client->is_connected()) {
+            [worker = &ctx.session.worker(), session = ctx.session.weak_from_this(), world_name] {
+                auto locked{ session.lock() };
+                if (!locked) {
                     spdlog::warn("Client disconnected before warp could complete.");
                     return;
                 }
@@ -55,10 +59,15 @@ public:
                 packet::message::JoinRequest join_pkt{};
                 join_pkt.world_name = world_name;
                 join_pkt.invited_world = false;
-                packet::PacketHelper::write(join_pkt, *client);
+                if (!locked->inject(event::Direction::ServerBound, join_pkt)) {
+                    spdlog::warn("Failed to queue the warp to {}.", world_name);
+                }
+
+                // Dropping the last reference would destroy the session on this thread, let its shard do it
+                worker->execute([locked = std::move(locked)] { });
             },
             std::chrono::milliseconds{ 1750 },
-            "warp",
+            tag,
             core::TaskPriority::Normal
         );
 
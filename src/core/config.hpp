@@ -7,6 +7,7 @@ public:
     struct ServerConfig {
         int port{ 16999 };
         std::string address{ "www.growtopia1.com" };
+        int max_sessions{ 32 };
     };
 
     struct ClientConfig {
@@ -26,11 +27,35 @@ public:
         char prefix{ '/' };
     };
 
+    struct LoopConfig {
+        // "sleep" polls on a fixed interval, "event" parks on the ENet sockets until a datagram
+        // or timer arrives, "spin" busy-polls for spin_budget_us before parking like "event".
+        std::string mode{ "event" };
+        int sleep_interval_us{ 5000 };
+        int spin_budget_us{ 200 };
+        int max_wait_ms{ 10 };
+        // Worker threads sessions are spread across, 0 runs every session on the main thread.
+        int shards{ 0 };
+        // Packets the proxy sends to clients itself (commands, scripts, injected packets) are held up
+        // to this long so a burst leaves in fewer datagrams, 0 sends them with the next flush.
+        int coalesce_window_us{ 0 };
+    };
+
+    struct ScriptConfig {
+        // Off by default. Compiled scripts are written here and loaded back as binary chunks without
+        // being checked, so anyone who can write to it can escape the script sandbox. Only turn it on
+        // when the directory is as trusted as the scripts, otherwise chunks are only cached in memory.
+        bool bytecode_cache_on_disk{ false };
+        std::string bytecode_cache_directory{ "resources/bytecode" };
+    };
+
     struct WrapperConfig {
         ServerConfig server;
         ClientConfig client;
         LogConfig log;
         CommandConfig command;
+        LoopConfig loop;
+        ScriptConfig script;
     };
 
 public:
@@ -42,6 +67,8 @@ public:
     [[nodiscard]] const ClientConfig& get_client_config() const { return config_.client; }
     [[nodiscard]] const LogConfig& get_log_config() const { return config_.log; }
     [[nodiscard]] const CommandConfig& get_command_config() const { return config_.command; }
+    [[nodiscard]] const LoopConfig& get_loop_config() const { return config_.loop; }
+    [[nodiscard]] const ScriptConfig& get_script_config() const { return config_.script; }
 
 private:
     WrapperConfig config_;
@@ -1,97 +1,87 @@
 #include "core.hpp"
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
 #include <enet/enet.h>
 #include <spdlog/spdlog.h>
 
 #include "../packet/register_packets.hpp"
-#include "../scripting/bindings/command_bindings.hpp"
-#include "../scripting/bindings/event_bindings.hpp"
-#include "../scripting/bindings/logger_bindings.hpp"
-#include "../scripting/bindings/packet_bindings.hpp"
-#include "../scripting/bindings/scheduler_bindings.hpp"
-#include "../scripting/bindings/player_bindings.hpp"
-#include "../scripting/bindings/world_bindings.hpp"
-#include "../scripting/bindings/world_data_bindings.hpp"
-#include "../scripting/bindings/item_bindings.hpp"
+#include "../scripting/bytecode_cache.hpp"
 
 namespace core {
 Core::Core()
     : running_{ true }
     , scheduler_{ std::make_shared<Scheduler>() }
+    , inline_shard_{ nullptr }
 {
     if (enet_initialize() != 0) {
         throw std::runtime_error{ "Failed to initialize ENet" };
     }
 
-    server_ = std::make_unique<network::Server>(config_, dispatcher_);
-    client_ = std::make_unique<network::Client>(config_, dispatcher_);
-    web_server_ = std::make_unique<WebServer>(config_, dispatcher_, *client_, *server_);
+    event_loop_ = std::make_unique<EventLoop>(config_.get_loop_config());
 
-    packet::register_all_packets();
-
-    connection_handler_ = std::make_unique<handlers::ConnectionHandler>(dispatcher_, *client_, *server_, config_);
-    forwarding_handler_ = std::make_unique<handlers::ForwardingHandler>(dispatcher_, *client_, *server_);
-    world_handler_ = std::make_unique<handlers::WorldHandler>(dispatcher_);
-    command_handler_ = std::make_unique<command::CommandHandler>(config_, dispatcher_, scheduler_, *server_, *client_);
-
-    script_engine_ = std::make_unique<scripting::LuaEngine>();
+    server_ = std::make_unique<network::Server>(config_, *event_loop_);
+    web_server_ = std::make_unique<WebServer>(config_, *server_);
 
-    script_scheduler_ = std::make_unique<scripting::ScriptScheduler>(*script_engine_);
+    packet::register_all_packets();
+    scripting::BytecodeCache::instance().configure(config_.get_script_config());
 
-    script_event_bridge_ = std::make_unique<scripting::ScriptEventBridge>(
-        dispatcher_,
-        *script_engine_,
-        *client_,
-        *server_
-    );
+    const int shard_count{ config_.get_loop_config().shards };
+    if (shard_count <= 0) {
+        shards_.push_back(std::make_unique<Shard>(0, config_, *server_, scheduler_, event_loop_.get()));
+        inline_shard_ = shards_.front().get();
+    }
 
-    script_engine_->register_binding(std::make_unique<scripting::bindings::CommandBindings>(*command_handler_, *server_, *client_, dispatcher_, scheduler_));
-    script_engine_->register_binding(std::make_unique<scripting::bindings::EventBindings>(*script_event_bridge_));
-    script_engine_->register_binding(std::make_unique<scripting::bindings::LoggerBindings>());
-    script_engine_->register_binding(std::make_unique<scripting::bindings::PacketBindings>(*client_, *server_));
-    script_engine_->register_binding(std::make_unique<scripting::bindings::SchedulerBindings>(*script_scheduler_));
-    script_engine_->register_binding(std::make_unique<scripting::bindings::PlayerBindings>());
-    script_engine_->register_binding(std::make_unique<scripting::bindings::WorldBindings>());
-    script_engine_->register_binding(std::make_unique<scripting::bindings::WorldDataBindings>());
-    script_engine_->register_binding(std::make_unique<scripting::bindings::ItemBindings>());
+    for (int i{ 0 }; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>(static_cast<std::size_t>(i), config_, *server_, scheduler_));
+    }
 
-    script_loader_ = std::make_unique<scripting::ScriptLoader>(*script_engine_, "scripts");
-    script_loader_->load_all();
+    for (const auto& shard : shards_) {
+        server_->add_worker(*shard);
+        shard->start();
+    }
 
     spdlog::info("Core initialized successfully");
 }
 
 Core::~Core()
 {
+    // Scheduler tasks hand work to the shards, stop them before the shards go away
+    scheduler_->stop();
+
+    // Shards own ENet hosts and may still be running
+    shards_.clear();
+
     enet_deinitialize();
 }
 
 void Core::run() const
 {
-    constexpr auto sleep_timer = std::chrono::microseconds{ 5000 };
-    auto prev = std::chrono::high_resolution_clock::now();
-    auto sleep_duration = sleep_timer;
-
     while (running_) {
-        const auto now = std::chrono::high_resolution_clock::now();
-        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - prev);
-        prev = now;
-
-        sleep_duration += sleep_timer - elapsed;
-
         server_->process();
-        client_->process();
-        script_scheduler_->update(elapsed);
 
-        if (sleep_duration > std::chrono::microseconds::zero()) {
-            std::this_thread::sleep_for(sleep_duration);
+        if (inline_shard_) {
+            inline_shard_->process();
         }
 
-        if (sleep_duration >= sleep_timer) {
-            sleep_duration = std::chrono::microseconds::zero();
+        // Flush stage: downstream writes are queued by the shards, push them out before parking
+        server_->flush();
+
+        auto deadline{ server_->next_deadline().value_or(EventLoop::Clock::time_point::max()) };
+        if (inline_shard_) {
+            deadline = std::min(deadline, inline_shard_->next_deadline().value_or(EventLoop::Clock::time_point::max()));
         }
+
+        event_loop_->wait(deadline);
+    }
+}
+
+void Core::stop()
+{
+    running_ = false;
+
+    if (event_loop_) {
+        event_loop_->wake();
     }
 }
 }
@@ -0,0 +1,197 @@
+#include "event_loop.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <thread>
+#include <magic_enum/magic_enum.hpp>
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+EventLoop::EventLoop(const Config::LoopConfig& config)
+    : mode_{ parse_mode(config.mode) }
+    , sleep_interval_{ std::max(config.sleep_interval_us, 0) }
+    , spin_budget_{ std::max(config.spin_budget_us, 0) }
+    , max_wait_{ std::max(config.max_wait_ms, 1) }
+#ifdef __linux__
+    , epoll_fd_{ epoll_create1(EPOLL_CLOEXEC) }
+    , timer_fd_{ timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) }
+    , wake_fd_{ eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) }
+#endif
+{
+#ifdef __linux__
+    if (epoll_fd_ < 0 || timer_fd_ < 0 || wake_fd_ < 0) {
+        throw std::runtime_error{ "Failed to create event loop descriptors" };
+    }
+
+    for (const int fd : { timer_fd_, wake_fd_ }) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            throw std::runtime_error{ "Failed to register event loop descriptor" };
+        }
+    }
+#endif
+
+    spdlog::info("Event loop running in {} mode", magic_enum::enum_name(mode_));
+}
+
+EventLoop::~EventLoop()
+{
+#ifdef __linux__
+    for (const int fd : { wake_fd_, timer_fd_, epoll_fd_ }) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+EventLoop::Mode EventLoop::parse_mode(const std::string& mode)
+{
+    if (mode == "sleep") {
+        return Mode::Sleep;
+    }
+
+    if (mode == "event") {
+        return Mode::Event;
+    }
+
+    if (mode == "spin") {
+        return Mode::Spin;
+    }
+
+    spdlog::warn("Unknown event loop mode: {}, defaulting to event", mode);
+    return Mode::Event;
+}
+
+void EventLoop::add_socket(const ENetSocket socket)
+{
+    if (socket == ENET_SOCKET_NULL || std::ranges::find(sockets_, socket) != sockets_.end()) {
+        return;
+    }
+
+    sockets_.push_back(socket);
+
+#ifdef __linux__
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = socket;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket, &ev) != 0) {
+        spdlog::warn("Failed to watch socket {} in event loop", socket);
+    }
+#endif
+}
+
+void EventLoop::remove_socket(const ENetSocket socket)
+{
+    if (std::erase(sockets_, socket) == 0) {
+        return;
+    }
+
+#ifdef __linux__
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+#endif
+}
+
+void EventLoop::wait(Clock::time_point deadline)
+{
+    const auto now{ Clock::now() };
+    deadline = std::min(deadline, now + max_wait_);
+
+    switch (mode_) {
+    case Mode::Sleep:
+        std::this_thread::sleep_until(std::min(deadline, now + sleep_interval_));
+        break;
+    case Mode::Spin: {
+        const auto spin_until{ std::min(deadline, now + spin_budget_) };
+        while (Clock::now() < spin_until) {
+            if (poll_sockets(0)) {
+                return;
+            }
+        }
+
+        if (Clock::now() < deadline) {
+            park(deadline);
+        }
+        break;
+    }
+    case Mode::Event:
+        park(deadline);
+        break;
+    }
+}
+
+void EventLoop::wake() const
+{
+#ifdef __linux__
+    constexpr std::uint64_t one{ 1 };
+    std::ignore = write(wake_fd_, &one, sizeof(one));
+#endif
+}
+
+bool EventLoop::poll_sockets(const int timeout_ms) const
+{
+#ifdef __linux__
+    std::array<epoll_event, 16> events{};
+    const int count{ epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), timeout_ms) };
+
+    for (int i{ 0 }; i < count; ++i) {
+        if (const int fd{ events[i].data.fd }; fd == timer_fd_ || fd == wake_fd_) {
+            std::uint64_t expirations{ 0 };
+            std::ignore = read(fd, &expirations, sizeof(expirations));
+        }
+    }
+
+    return count > 0;
+#else
+    if (sockets_.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ timeout_ms });
+        return false;
+    }
+
+    ENetSocketSet read_set;
+    ENET_SOCKETSET_EMPTY(read_set);
+
+    ENetSocket max_socket{ sockets_.front() };
+    for (const auto socket : sockets_) {
+        ENET_SOCKETSET_ADD(read_set, socket);
+        max_socket = std::max(max_socket, socket);
+    }
+
+    return enet_socketset_select(max_socket, &read_set, nullptr, static_cast<enet_uint32>(timeout_ms)) > 0;
+#endif
+}
+
+void EventLoop::park(const Clock::time_point deadline) const
+{
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC on Linux, so the deadline can be armed as an absolute timer
+    const auto since_epoch{ std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()) };
+
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(since_epoch.count() / 1'000'000'000);
+    spec.it_value.tv_nsec = static_cast<long>(since_epoch.count() % 1'000'000'000);
+
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        spec.it_value.tv_nsec = 1;
+    }
+
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    std::ignore = poll_sockets(-1);
+#else
+    const auto remaining{ std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()) };
+    std::ignore = poll_sockets(static_cast<int>(std::max<std::int64_t>(remaining.count(), 0)));
+#endif
+}
+}
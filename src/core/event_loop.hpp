@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <enet/enet.h>
+
+#include "config.hpp"
+#include "../utils/types.hpp"
+
+namespace core {
+class EventLoop final : public utils::types::Immobile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+        Sleep,
+        Event,
+        Spin
+    };
+
+    explicit EventLoop(const Config::LoopConfig& config);
+    ~EventLoop();
+
+    void add_socket(ENetSocket socket);
+    void remove_socket(ENetSocket socket);
+
+    // Blocks until one of the watched sockets is readable, the deadline is reached or wake() is called.
+    // The deadline is clamped to max_wait_ms so ENet still gets serviced for its retransmit timers.
+    void wait(Clock::time_point deadline);
+
+    // Safe to call from any thread and from a signal handler.
+    void wake() const;
+
+    [[nodiscard]] Mode mode() const { return mode_; }
+
+private:
+    [[nodiscard]] bool poll_sockets(int timeout_ms) const;
+    void park(Clock::time_point deadline) const;
+
+    static Mode parse_mode(const std::string& mode);
+
+private:
+    Mode mode_;
+    std::chrono::microseconds sleep_interval_;
+    std::chrono::microseconds spin_budget_;
+    std::chrono::milliseconds max_wait_;
+
+    std::vector<ENetSocket> sockets_;
+
+#ifdef __linux__
+    int epoll_fd_;
+    int timer_fd_;
+    int wake_fd_;
+#endif
+};
+}
@@ -1,21 +1,27 @@
 #include "connection_handler.hpp"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "../../packet/generic_packets.hpp"
 #include "../../packet/game/server.hpp"
 #include "../../packet/game/item_database.hpp"
+#include "../../packet/message/server_hello.hpp"
+#include "../../utils/text_parse_view.hpp"
 
 namespace core::handlers {
 ConnectionHandler::ConnectionHandler(
     event::Dispatcher& dispatcher,
-    network::Client& client,
     network::Server& server,
     Config& config
 )
     : dispatcher_{ dispatcher }
-    , client_{ client }
     , server_{ server }
     , config_{ config }
 {
     setup_connection_handlers();
+    setup_login_handlers();
     setup_on_send_to_server_handler();
     setup_quit_handler();
     setup_disconnect_handler();
@@ -28,43 +34,134 @@ void ConnectionHandler::setup_connection_handlers()
     handles_.emplace_back(
         dispatcher_,
         event::Type::ClientConnect,
-        dispatcher_.appendListener(event::Type::ClientConnect, [this](const event::Event&) {
-            if (pending_port_ == 65535) {
+        dispatcher_.appendListener(event::Type::ClientConnect, [](const event::Event& event) {
+            if (!event.session) {
                 return;
             }
 
-            spdlog::info("Connecting to Growtopia server at {}:{}", pending_address_, pending_port_);
-            client_.connect(pending_address_, pending_port_);
-
-            pending_address_.clear();
-            pending_port_ = 65535;
-        })
+            // Greet the client like a Growtopia server would, its login packet picks the upstream route
+            packet::message::ServerHello hello{};
+            std::ignore = packet::PacketHelper::write(hello, event.session->downstream());
+        }, event::Priority::Normal, "ConnectionHandler::client_connect")
     );
 
     handles_.emplace_back(
         dispatcher_,
         event::Type::ClientDisconnect,
-        dispatcher_.appendListener(event::Type::ClientDisconnect, [this](const event::Event&) {
-            if (!client_.is_connected()) {
+        dispatcher_.appendListener(event::Type::ClientDisconnect, [](const event::Event& event) {
+            if (!event.session || !event.session->upstream().is_active()) {
                 return;
             }
 
-            client_.disconnect();
-            spdlog::info("Gracefully disconnect Growtopia client from proxy server");
-        })
+            event.session->upstream().disconnect();
+            spdlog::info("Gracefully disconnect session {} from Growtopia server", event.session->id());
+        }, event::Priority::Normal, "ConnectionHandler::client_disconnect")
     );
 
     handles_.emplace_back(
         dispatcher_,
         event::Type::ServerDisconnect,
-        dispatcher_.appendListener(event::Type::ServerDisconnect, [this](const event::Event&) {
-            if (!server_.is_connected()) {
+        dispatcher_.appendListener(event::Type::ServerDisconnect, [](const event::Event& event) {
+            if (!event.session || !event.session->downstream().is_connected()) {
                 return;
             }
 
-            server_.disconnect();
-            spdlog::info("Gracefully disconnect Growtopia client from proxy server");
-        })
+            event.session->downstream().disconnect();
+            spdlog::info("Gracefully disconnect session {} from proxy server", event.session->id());
+        }, event::Priority::Normal, "ConnectionHandler::server_disconnect")
+    );
+}
+
+void ConnectionHandler::setup_login_handlers()
+{
+    handles_.emplace_back(
+        dispatcher_,
+        event::Type::ServerBoundPacket,
+        dispatcher_.on_raw_packet(event::Direction::ServerBound, [this](const event::RawPacketEvent& raw_packet) {
+            if (!raw_packet.session || raw_packet.session->is_routed()) {
+                return;
+            }
+
+            // Nothing is forwarded until the login tells where to, there is no upstream yet anyway
+            raw_packet.cancel();
+
+            auto& session{ *raw_packet.session };
+            packet::NetMessageType message_type{};
+            if (raw_packet.data.size() <= sizeof(message_type)) {
+                return;
+            }
+
+            std::memcpy(&message_type, raw_packet.data.data(), sizeof(message_type));
+            if (message_type != packet::NET_MESSAGE_GENERIC_TEXT) {
+                return;
+            }
+
+            std::string_view text{
+                reinterpret_cast<const char*>(raw_packet.data.data()) + sizeof(message_type),
+                raw_packet.data.size() - sizeof(message_type)
+            };
+            while (!text.empty() && text.back() == '\0') {
+                text.remove_suffix(1);
+            }
+
+            const utils::TextParseView login{ text };
+
+            auto route{ server_.routes().take(network::RouteTable::transfer_key(
+                login.get<std::string_view>("user"),
+                login.get<std::string_view>("token")
+            )) };
+            if (!route) {
+                route = server_.routes().take(network::RouteTable::meta_key(login.get<std::string_view>("meta")));
+            }
+
+            if (!route) {
+                spdlog::warn("No pending route for session {} ({}), disconnecting", session.id(), session.address());
+                session.downstream().disconnect();
+                return;
+            }
+
+            if (route->meta.empty()) {
+                session.hold_login({ raw_packet.data.begin(), raw_packet.data.end() });
+            }
+            else {
+                packet::GenericTextPacket rewritten{};
+                rewritten.message_type = packet::NET_MESSAGE_GENERIC_TEXT;
+                rewritten.text_parse() = login.to_owned();
+                rewritten.text_parse().set("meta", { route->meta });
+
+                auto data{ packet::PacketHelper::serialize(rewritten) };
+                data.push_back(static_cast<std::byte>(0x00));
+                session.hold_login(std::move(data));
+            }
+
+            spdlog::info(
+                "Connecting session {} to Growtopia server at {}:{}",
+                session.id(),
+                route->address,
+                route->port
+            );
+            session.upstream().connect(route->address, route->port);
+        }, event::Priority::Highest, "ConnectionHandler::route_login")
+    );
+
+    constexpr auto server_hello_type{ event::packet_event_type(packet::PacketId::ServerHello) };
+    handles_.emplace_back(
+        dispatcher_,
+        server_hello_type,
+        dispatcher_.on<packet::PacketId::ServerHello>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::ServerHello>& evt) {
+            if (!evt.session) {
+                return;
+            }
+
+            const auto login{ evt.session->take_held_login() };
+            if (!login) {
+                return;
+            }
+
+            // The client has been greeted by the proxy already, answer the server with its login instead
+            std::ignore = evt.session->upstream().write(*login);
+            evt.cancel();
+        }, event::Priority::Highest, "ConnectionHandler::server_hello")
     );
 }
 
@@ -74,27 +171,29 @@ void ConnectionHandler::setup_on_send_to_server_handler()
     handles_.emplace_back(
         dispatcher_,
         on_send_to_server_type,
-        dispatcher_.appendListener(on_send_to_server_type, [this](const event::Event& event) {
-            const auto* evt = dynamic_cast<const event::TypedPacketEvent<packet::PacketId::OnSendToServer>*>(&event);
-            if (!evt) {
+        dispatcher_.on<packet::PacketId::OnSendToServer>([this](const event::TypedPacketEvent<packet::PacketId::OnSendToServer>& evt) {
+            if (!evt.session) {
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::OnSendToServer>() };
+            const auto pkt{ evt.get<packet::game::OnSendToServer>() };
             if (!pkt) {
                 return;
             }
 
-            pending_address_ = pkt->address;
-            pending_port_ = pkt->port;
+            // The client reconnects as a new peer and logs in with this user and token, see route_login
+            server_.routes().push(
+                network::RouteTable::transfer_key(std::to_string(pkt->user), std::to_string(pkt->token)),
+                { pkt->address, pkt->port }
+            );
 
             const auto modified_pkt = std::make_shared<packet::game::OnSendToServer>(*pkt);
             modified_pkt->address = "127.0.0.1";
             modified_pkt->port = config_.get_server_config().port;
 
-            std::ignore = packet::PacketHelper::write(*modified_pkt, server_);
-            evt->cancel();
-        })
+            std::ignore = packet::PacketHelper::write(*modified_pkt, evt.session->downstream());
+            evt.cancel();
+        }, event::Priority::Normal, "ConnectionHandler::on_send_to_server")
     );
 }
 
@@ -104,18 +203,15 @@ void ConnectionHandler::setup_quit_handler()
     handles_.emplace_back(
         dispatcher_,
         quit_type,
-        dispatcher_.appendListener(quit_type, [this](const event::Event& event) {
-            if (
-                const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::Quit>*>(&event) };
-                !evt || evt->direction != event::Direction::ServerBound
-            ) {
+        dispatcher_.on<packet::PacketId::Quit>(event::Direction::ServerBound, [](const event::TypedPacketEvent<packet::PacketId::Quit>& evt) {
+            if (!evt.session) {
                 return;
             }
 
-            server_.disconnect();
-            client_.disconnect_now();
+            evt.session->downstream().disconnect();
+            evt.session->upstream().disconnect_now();
             spdlog::info("Forced disconnect proxy client from Growtopia server");
-        })
+        }, event::Priority::Normal, "ConnectionHandler::quit")
     );
 }
 
@@ -125,19 +221,16 @@ void ConnectionHandler::setup_disconnect_handler()
     handles_.emplace_back(
         dispatcher_,
         disconnect_type,
-        dispatcher_.appendListener(disconnect_type, [this](const event::Event& event) {
-            if (
-                const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::Disconnect>*>(&event) };
-                !evt || evt->direction != event::Direction::ServerBound
-            ) {
+        dispatcher_.on<packet::PacketId::Disconnect>(event::Direction::ServerBound, [](const event::TypedPacketEvent<packet::PacketId::Disconnect>& evt) {
+            if (!evt.session) {
                 return;
             }
 
-            server_.disconnect_now();
+            evt.session->downstream().disconnect_now();
             spdlog::info("Forced disconnect proxy server from Growtopia client");
-            client_.disconnect_now();
+            evt.session->upstream().disconnect_now();
             spdlog::info("Forced disconnect proxy client from Growtopia server");
-        })
+        }, event::Priority::Normal, "ConnectionHandler::disconnect")
     );
 }
 
@@ -147,15 +240,21 @@ void ConnectionHandler::setup_send_item_database_data_handler()
     handles_.emplace_back(
         dispatcher_,
         send_item_database_data_type,
-        dispatcher_.appendListener(send_item_database_data_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::SendItemDatabaseData>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
+        // Parsing and caching items.dat only reads the packet, it runs as an observer off the forwarding path
+        dispatcher_.observe<packet::PacketId::SendItemDatabaseData>(event::Direction::ClientBound, [](const event::ObservedPacket& observed) {
+            const auto pkt{ observed.get<packet::game::SendItemDatabaseData>() };
+            if (!pkt || pkt->items_dat.empty()) {
+                spdlog::warn("No data to parse");
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::SendItemDatabaseData>() };
-            if (!pkt || pkt->items_dat.empty()) {
-                spdlog::warn("No data to parse");
+            // Every session on every shard gets sent items.dat, only one the database has not seen yet
+            // is parsed and cached, and it replaces the previous one
+            const auto hash{ utils::hash::proton(
+                reinterpret_cast<const char*>(pkt->items_dat.data()),
+                pkt->items_dat.size()
+            ) };
+            if (item::ItemDatabase::instance().is_current(hash)) {
                 return;
             }
 
@@ -178,13 +277,19 @@ void ConnectionHandler::setup_send_item_database_data_handler()
             // ReSharper disable once CppVariableCanBeMadeConstexpr
             const std::string cache_path{ "resources/items.dat" };
             try {
-                std::ofstream out{ cache_path, std::ios::binary };
-                if (!out) {
-                    spdlog::warn("Failed to open items.dat for writing: {}", cache_path);
-                    return;
+                // Other shards may be hashing the cache right now, replace it in one step
+                const std::string temp_path{ cache_path + ".tmp" };
+                {
+                    std::ofstream out{ temp_path, std::ios::binary };
+                    if (!out) {
+                        spdlog::warn("Failed to open items.dat for writing: {}", temp_path);
+                        return;
+                    }
+
+                    out.write(reinterpret_cast<const char*>(pkt->items_dat.data()), pkt->items_dat.size());
                 }
 
-                out.write(reinterpret_cast<const char*>(pkt->items_dat.data()), pkt->items_dat.size());
+                std::filesystem::rename(temp_path, cache_path);
                 spdlog::info("Saved items.dat to {} ({} bytes)", cache_path, pkt->items_dat.size());
             } catch (const std::exception& e) {
                 spdlog::error("Failed to save items.dat: {}", e.what());
@@ -199,20 +304,20 @@ void ConnectionHandler::setup_on_super_main_start_handler()
     handles_.emplace_back(
         dispatcher_,
         on_send_to_server_type,
-        dispatcher_.appendListener(on_send_to_server_type, [](const event::Event& event) {
-            const auto* evt = dynamic_cast<const event::TypedPacketEvent<packet::PacketId::OnSuperMainStartAcceptLogonHrdxs47254722215a>*>(&event);
-            if (!evt) {
+        // Hashing and loading the cached items.dat is file I/O, kept off the forwarding path as well
+        dispatcher_.observe<packet::PacketId::OnSuperMainStartAcceptLogonHrdxs47254722215a>(event::Direction::ClientBound, [](const event::ObservedPacket& observed) {
+            const auto pkt{ observed.get<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a>() };
+            if (!pkt) {
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a>() };
-            if (!pkt) {
+            const auto server_hash{ static_cast<std::uint32_t>(pkt->item_hash) };
+            if (item::ItemDatabase::instance().is_current(server_hash)) {
                 return;
             }
 
             // ReSharper disable once CppVariableCanBeMadeConstexpr
             const std::string cache_path{ "resources/items.dat" };
-            const auto server_hash{ static_cast<std::uint32_t>(pkt->item_hash) };
             const auto cached_hash{ (utils::hash::proton_file(cache_path)) };
 
             if (server_hash != cached_hash) {
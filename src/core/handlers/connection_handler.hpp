@@ -1,9 +1,7 @@
 #pragma once
-#include <string>
 #include <vector>
 
 #include "../../event/event.hpp"
-#include "../../network/client.hpp"
 #include "../../network/server.hpp"
 #include "../../utils/hash.hpp"
 #include "../config.hpp"
@@ -13,13 +11,13 @@ class ConnectionHandler {
 public:
     ConnectionHandler(
         event::Dispatcher& dispatcher,
-        network::Client& client,
         network::Server& server,
         Config& config
     );
 
 private:
     void setup_connection_handlers();
+    void setup_login_handlers();
     void setup_on_send_to_server_handler();
     void setup_quit_handler();
     void setup_disconnect_handler();
@@ -28,13 +26,9 @@ private:
 
 private:
     event::Dispatcher& dispatcher_;
-    network::Client& client_;
     network::Server& server_;
     Config& config_;
 
-    std::string pending_address_;
-    uint16_t pending_port_;
-
     std::vector<event::ScopedHandle> handles_;
 };
 }
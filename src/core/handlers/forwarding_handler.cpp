@@ -1,14 +1,10 @@
 #include "forwarding_handler.hpp"
 
+#include "../../network/session.hpp"
+
 namespace core::handlers {
-ForwardingHandler::ForwardingHandler(
-    event::Dispatcher& dispatcher,
-    network::Client& client,
-    network::Server& server
-)
+ForwardingHandler::ForwardingHandler(event::Dispatcher& dispatcher)
     : dispatcher_{ dispatcher }
-    , client_{ client }
-    , server_{ server }
 {
     setup_raw_packet_handlers();
 }
@@ -18,27 +14,37 @@ void ForwardingHandler::setup_raw_packet_handlers()
     handles_.emplace_back(
         dispatcher_,
         event::Type::ClientBoundPacket,
-        dispatcher_.appendListener(event::Type::ClientBoundPacket, [this](const event::Event& event) {
-            const auto raw_packet{ dynamic_cast<const event::RawPacketEvent*>(&event) };
-            if (!raw_packet) {
+        dispatcher_.on_raw_packet(event::Direction::ClientBound, [](const event::RawPacketEvent& raw_packet) {
+            if (!raw_packet.session) {
                 return;
             }
 
-            std::ignore = server_.write(raw_packet->data);
-        })
+            auto& downstream{ raw_packet.session->downstream() };
+            if (raw_packet.packet) {
+                downstream.forward(*raw_packet.packet, raw_packet.channel);
+            }
+            else {
+                std::ignore = downstream.write(raw_packet.data, raw_packet.channel, raw_packet.flags);
+            }
+        }, event::Priority::Normal, "ForwardingHandler::forward_client_bound")
     );
 
     handles_.emplace_back(
         dispatcher_,
         event::Type::ServerBoundPacket,
-        dispatcher_.appendListener(event::Type::ServerBoundPacket, [this](const event::Event& event) {
-            const auto raw_packet{ dynamic_cast<const event::RawPacketEvent*>(&event) };
-            if (!raw_packet) {
+        dispatcher_.on_raw_packet(event::Direction::ServerBound, [](const event::RawPacketEvent& raw_packet) {
+            if (!raw_packet.session) {
                 return;
             }
 
-            std::ignore = client_.write(raw_packet->data);
-        })
+            auto& upstream{ raw_packet.session->upstream() };
+            if (raw_packet.packet) {
+                upstream.forward(*raw_packet.packet, raw_packet.channel);
+            }
+            else {
+                std::ignore = upstream.write(raw_packet.data, raw_packet.channel, raw_packet.flags);
+            }
+        }, event::Priority::Normal, "ForwardingHandler::forward_server_bound")
     );
 }
 }
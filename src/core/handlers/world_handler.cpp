@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 
 #include "../../event/event.hpp"
+#include "../../network/session.hpp"
 #include "../../packet/game/world.hpp"
 #include "../../world/world.hpp"
 #include "../../world/object.hpp"
@@ -29,16 +30,13 @@ void WorldHandler::setup_join_request_handler()
     handles_.emplace_back(
         dispatcher_,
         join_request_type,
-        dispatcher_.appendListener(join_request_type, [](const event::Event& event) {
-            if (
-                const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::JoinRequest>*>(&event) };
-                !evt || evt->direction != event::Direction::ServerBound
-            ) {
+        dispatcher_.on<packet::PacketId::JoinRequest>(event::Direction::ServerBound, [](const event::TypedPacketEvent<packet::PacketId::JoinRequest>& evt) {
+            if (!evt.session) {
                 return;
             }
 
-            world::World::instance().clear();
-        })
+            evt.session->world().clear();
+        }, event::Priority::Normal, "WorldHandler::join_request")
     );
 }
 
@@ -48,20 +46,15 @@ void WorldHandler::setup_on_spawn_handler()
     handles_.emplace_back(
         dispatcher_,
         on_spawn_type,
-        dispatcher_.appendListener(on_spawn_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::OnSpawn>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
-                return;
-            }
-
-            const auto pkt{ evt->get<packet::game::OnSpawn>() };
-            if (!pkt) {
+        dispatcher_.on<packet::PacketId::OnSpawn>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::OnSpawn>& evt) {
+            const auto pkt{ evt.get<packet::game::OnSpawn>() };
+            if (!pkt || !evt.session) {
                 return;
             }
 
             const auto player{ player::Player::from_on_spawn(*pkt) };
-            world::World::instance().add_player(player);
-        })
+            evt.session->world().add_player(player);
+        }, event::Priority::Normal, "WorldHandler::on_spawn")
     );
 }
 
@@ -71,19 +64,14 @@ void WorldHandler::setup_on_remove_handler()
     handles_.emplace_back(
         dispatcher_,
         on_remove_type,
-        dispatcher_.appendListener(on_remove_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::OnRemove>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
+        dispatcher_.on<packet::PacketId::OnRemove>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::OnRemove>& evt) {
+            const auto pkt{ evt.get<packet::game::OnRemove>() };
+            if (!pkt || !evt.session) {
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::OnRemove>() };
-            if (!pkt) {
-                return;
-            }
-
-            world::World::instance().remove_player(pkt->net_id);
-        })
+            evt.session->world().remove_player(pkt->net_id);
+        }, event::Priority::Normal, "WorldHandler::on_remove")
     );
 }
 
@@ -93,19 +81,14 @@ void WorldHandler::setup_send_map_data_handler()
     handles_.emplace_back(
         dispatcher_,
         send_map_data_type,
-        dispatcher_.appendListener(send_map_data_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::SendMapData>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
-                return;
-            }
-
-            const auto pkt{ evt->get<packet::game::SendMapData>() };
-            if (!pkt || pkt->extra.empty()) {
+        dispatcher_.on<packet::PacketId::SendMapData>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::SendMapData>& evt) {
+            const auto pkt{ evt.get<packet::game::SendMapData>() };
+            if (!pkt || pkt->extra.empty() || !evt.session) {
                 return;
             }
 
-            world::World::instance().serialize(pkt->extra.data(), pkt->extra.size());
-        })
+            evt.session->world().serialize(pkt->extra.data(), pkt->extra.size());
+        }, event::Priority::Normal, "WorldHandler::send_map_data")
     );
 }
 
@@ -115,18 +98,13 @@ void WorldHandler::setup_send_tile_update_data_handler()
     handles_.emplace_back(
         dispatcher_,
         send_tile_update_data_type,
-        dispatcher_.appendListener(send_tile_update_data_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::SendTileUpdateData>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
+        dispatcher_.on<packet::PacketId::SendTileUpdateData>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::SendTileUpdateData>& evt) {
+            const auto pkt{ evt.get<packet::game::SendTileUpdateData>() };
+            if (!pkt || pkt->extra.empty() || !evt.session) {
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::SendTileUpdateData>() };
-            if (!pkt || pkt->extra.empty()) {
-                return;
-            }
-
-            const auto& world{ world::World::instance() };
+            const auto& world{ evt.session->world() };
             world::Tile tile{};
 
             utils::ByteStream<> bs{ pkt->extra.data(), pkt->extra.size() };
@@ -135,7 +113,7 @@ void WorldHandler::setup_send_tile_update_data_handler()
             // Update tile in map if coordinates are available in game_packet
             // Note: SendTileUpdateData typically doesn't include coords in the packet itself
             // The coordinates would need to come from parsing the extended data
-        })
+        }, event::Priority::Normal, "WorldHandler::send_tile_update_data")
     );
 }
 
@@ -145,18 +123,13 @@ void WorldHandler::setup_tile_change_request_handler()
     handles_.emplace_back(
         dispatcher_,
         tile_change_request_type,
-        dispatcher_.appendListener(tile_change_request_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::TileChangeRequest>*>(&event) };
-            if (!evt) {
+        dispatcher_.on<packet::PacketId::TileChangeRequest>([](const event::TypedPacketEvent<packet::PacketId::TileChangeRequest>& evt) {
+            const auto pkt{ evt.get<packet::game::TileChangeRequest>() };
+            if (!pkt || !evt.session) {
                 return;
             }
 
-            const auto pkt{ evt->get<packet::game::TileChangeRequest>() };
-            if (!pkt) {
-                return;
-            }
-
-            auto& world{ world::World::instance() };
+            auto& world{ evt.session->world() };
             auto& tile_map{ world.get_tile_map() };const std::uint32_t index{ static_cast<std::uint32_t>(pkt->int_x + pkt->int_y * tile_map.get_size().x) };
             if (index >= tile_map.get_tiles().size()) {
                 return;
@@ -172,7 +145,7 @@ void WorldHandler::setup_tile_change_request_handler()
             }
 
             // TODO: Block placement requires ItemDatabase
-        })
+        }, event::Priority::Normal, "WorldHandler::tile_change_request")
     );
 }
 
@@ -182,18 +155,13 @@ void WorldHandler::setup_item_change_object_handler()
     handles_.emplace_back(
         dispatcher_,
         item_change_object_type,
-        dispatcher_.appendListener(item_change_object_type, [](const event::Event& event) {
-            const auto evt{ dynamic_cast<const event::TypedPacketEvent<packet::PacketId::ItemChangeObject>*>(&event) };
-            if (!evt || evt->direction != event::Direction::ClientBound) {
-                return;
-            }
-
-            const auto pkt{ evt->get<packet::game::ItemChangeObject>() };
-            if (!pkt) {
+        dispatcher_.on<packet::PacketId::ItemChangeObject>(event::Direction::ClientBound, [](const event::TypedPacketEvent<packet::PacketId::ItemChangeObject>& evt) {
+            const auto pkt{ evt.get<packet::game::ItemChangeObject>() };
+            if (!pkt || !evt.session) {
                 return;
             }
 
-            auto& world{ world::World::instance() };
+            auto& world{ evt.session->world() };
             auto& object_map{ world.get_object_map() };
 
             if (pkt->object_change_type == -1) {
@@ -230,7 +198,7 @@ void WorldHandler::setup_item_change_object_handler()
                 
                 // TODO: Inventory updates
             }
-        })
+        }, event::Priority::Normal, "WorldHandler::item_change_object")
     );
 }
 }
@@ -0,0 +1,57 @@
+#include "loop_executor.hpp"
+
+#include <exception>
+#include <spdlog/spdlog.h>
+
+namespace core {
+LoopExecutor::LoopExecutor(EventLoop& event_loop)
+    : event_loop_{ event_loop }
+    , wake_pending_{ false }
+{ }
+
+void LoopExecutor::post(Task task)
+{
+    if (!task) {
+        return;
+    }
+
+    tasks_.push(std::move(task));
+
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        event_loop_.wake();
+    }
+}
+
+std::size_t LoopExecutor::drain()
+{
+    // Cleared before popping, a post() racing this drain wakes the loop again
+    wake_pending_.store(false, std::memory_order_release);
+
+    std::size_t count{ 0 };
+    while (count < MAX_BATCH) {
+        auto task{ tasks_.pop() };
+        if (!task) {
+            break;
+        }
+
+        ++count;
+
+        try {
+            (*task)();
+        }
+        catch (const std::exception& e) {
+            spdlog::error("Loop task threw exception: {}", e.what());
+        }
+        catch (...) {
+            spdlog::error("Loop task threw unknown exception");
+        }
+    }
+
+    // Either the batch was cut short or a producer is still linking its task, come back next iteration
+    if (!tasks_.empty() && !wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        event_loop_.wake();
+    }
+
+    return count;
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+#include "event_loop.hpp"
+#include "../utils/mpsc_queue.hpp"
+#include "../utils/types.hpp"
+
+namespace core {
+// Runs tasks on the thread driving an event loop, like a strand. Other threads hand work off with
+// post(), which never blocks, and the loop runs it from drain() once per iteration. Anything that
+// touches ENet hosts, sessions, worlds or the Lua state from outside the loop goes through here.
+class LoopExecutor final : public utils::types::Immobile {
+public:
+    using Task = std::function<void()>;
+
+    // Tasks run per drain(), the rest wait for the next iteration so they cannot starve the network
+    static constexpr std::size_t MAX_BATCH{ 256 };
+
+    explicit LoopExecutor(EventLoop& event_loop);
+    ~LoopExecutor() = default;
+
+    // Safe to call from any thread, including the loop thread itself
+    void post(Task task);
+
+    // Loop thread only, returns the number of tasks that ran
+    std::size_t drain();
+
+private:
+    EventLoop& event_loop_;
+    utils::MpscQueue<Task> tasks_;
+
+    // Set by the first post() after a drain, later posts skip the wake-up syscall
+    std::atomic<bool> wake_pending_;
+};
+}
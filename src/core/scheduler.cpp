@@ -1,27 +1,54 @@
 #include "scheduler.hpp"
 
 #include <algorithm>
+#include <iterator>
+#include <ranges>
 #include <spdlog/spdlog.h>
 
 namespace core {
-Scheduler::Scheduler(std::size_t num_threads)
-    : running_{ true }
+namespace {
+// Lets a task scheduled from inside a worker land on that worker's own deque
+thread_local const Scheduler* current_scheduler{ nullptr };
+thread_local std::size_t current_worker{ 0 };
+
+// Min-heap order, earlier deadlines first, then higher priority, then scheduling order
+constexpr auto LATER = [](const auto& a, const auto& b) {
+    if (a.execute_at != b.execute_at) {
+        return a.execute_at > b.execute_at;
+    }
+
+    if (a.priority != b.priority) {
+        return static_cast<std::int8_t>(a.priority) > static_cast<std::int8_t>(b.priority);
+    }
+
+    return a.task->id > b.task->id;
+};
+}
+
+Scheduler::Scheduler(std::size_t max_threads)
+    : worker_count_{ 0 }
+    , idle_workers_{ 0 }
+    , next_worker_{ 0 }
+    , work_available_{ 0 }
+    , running_{ true }
     , paused_{ false }
     , next_id_{ 1 }
-    , active_tasks_{ 0 }
+    , pending_{ 0 }
+    , outstanding_{ 0 }
 {
-    if (num_threads == 0) {
-        num_threads = 1;
+    if (max_threads == 0) {
+        max_threads = 1;
     }
 
-    workers_.reserve(num_threads);
-    for (std::size_t i = 0; i < num_threads; ++i) {
-        workers_.emplace_back(&Scheduler::worker_thread, this);
+    workers_.reserve(max_threads);
+    for (std::size_t i = 0; i < max_threads; ++i) {
+        workers_.emplace_back(std::make_unique<Worker>());
     }
 
+    grow();
     timer_thread_ = std::thread(&Scheduler::timer_thread, this);
 
-    spdlog::info("Scheduler started with {} worker threads", num_threads);
+    spdlog::info("Scheduler started with up to {} worker threads", max_threads);
 }
 
 Scheduler::~Scheduler()
@@ -31,25 +58,54 @@ Scheduler::~Scheduler()
 
 void Scheduler::stop()
 {
-    {
-        std::lock_guard lock(mutex_);
-        if (!running_) {
-            return;
-        }
-        running_ = false;
+    if (!running_.exchange(false)) {
+        return;
     }
 
+    {
+        std::lock_guard lock(timer_mutex_);
+    }
     timer_cv_.notify_all();
-    worker_cv_.notify_all();
 
     if (timer_thread_.joinable()) {
         timer_thread_.join();
     }
 
-    for (auto& worker : workers_) {
-        if (worker.joinable()) {
-            worker.join();
+    std::size_t count{};
+    {
+        // grow() checks running_ under this lock, no worker can start after this point
+        std::lock_guard lock(grow_mutex_);
+        count = worker_count_.load(std::memory_order_acquire);
+    }
+
+    // Workers drain what is already queued, then each one takes a permit it finds no task for
+    work_available_.release(static_cast<std::ptrdiff_t>(count));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        if (workers_[i]->thread.joinable()) {
+            workers_[i]->thread.join();
+        }
+    }
+
+    // Timers that never fired, periodic tasks that rescheduled themselves while stopping and anything
+    // a racing schedule() queued after the workers left are dropped, so wait_all() still returns
+    std::vector<TaskPtr> dropped{};
+    {
+        std::lock_guard lock(timer_mutex_);
+        for (auto& entry : timers_) {
+            dropped.push_back(std::move(entry.task));
         }
+        timers_.clear();
+    }
+
+    for (const auto& worker : workers_) {
+        std::lock_guard lock(worker->mutex);
+        std::ranges::move(worker->tasks, std::back_inserter(dropped));
+        worker->tasks.clear();
+    }
+
+    for (const auto& task : dropped) {
+        cancel(task);
     }
 
     spdlog::info("Scheduler stopped");
@@ -62,38 +118,7 @@ TaskId Scheduler::generate_id()
 
 TaskId Scheduler::schedule(std::function<void()> callback, const TaskOptions& options)
 {
-    if (!callback) {
-        return INVALID_TASK_ID;
-    }
-
-    const TaskId id = generate_id(); {
-        Task task{
-            .id = id,
-            .tag = options.tag,
-            .priority = options.priority,
-            .execute_at = std::chrono::steady_clock::now() + options.delay,
-            .interval = options.interval,
-            .callback = std::move(callback),
-            .should_continue = nullptr
-        };
-        std::lock_guard lock(mutex_);
-
-        if (!running_) {
-            return INVALID_TASK_ID;
-        }
-
-        pending_tasks_.insert(id);
-
-        if (!options.tag.empty()) {
-            tasks_by_tag_[options.tag].insert(id);
-        }
-
-        task_queue_.push(std::move(task));
-    }
-
-    timer_cv_.notify_one();
-
-    return id;
+    return submit(std::move(callback), options, nullptr);
 }
 
 TaskId Scheduler::schedule_delayed(
@@ -118,39 +143,12 @@ TaskId Scheduler::schedule_periodic(
     std::chrono::milliseconds initial_delay,
     std::shared_ptr<std::atomic<bool>> should_continue
 ) {
-    if (!callback) {
-        return INVALID_TASK_ID;
-    }
-
-    const TaskId id = generate_id();
-    {
-        Task task{
-            .id = id,
-            .tag = tag,
-            .priority = priority,
-            .execute_at = std::chrono::steady_clock::now() + initial_delay,
-            .interval = interval,
-            .callback = std::move(callback),
-            .should_continue = std::move(should_continue)
-        };
-        std::lock_guard lock(mutex_);
-
-        if (!running_) {
-            return INVALID_TASK_ID;
-        }
-
-        pending_tasks_.insert(id);
-
-        if (!tag.empty()) {
-            tasks_by_tag_[tag].insert(id);
-        }
-
-        task_queue_.push(std::move(task));
-    }
-
-    timer_cv_.notify_one();
-
-    return id;
+    return submit(std::move(callback), TaskOptions{
+        .tag = tag,
+        .priority = priority,
+        .delay = initial_delay,
+        .interval = interval
+    }, std::move(should_continue));
 }
 
 TaskId Scheduler::schedule_immediate(
@@ -166,20 +164,155 @@ TaskId Scheduler::schedule_immediate(
     });
 }
 
+TaskId Scheduler::submit(
+    std::function<void()> callback,
+    const TaskOptions& options,
+    std::shared_ptr<std::atomic<bool>> should_continue
+) {
+    if (!callback || !running_) {
+        return INVALID_TASK_ID;
+    }
+
+    auto task{ std::make_shared<Task>() };
+    task->id = generate_id();
+    task->tag = options.tag;
+    task->priority = options.priority;
+    task->execute_at = std::chrono::steady_clock::now() + options.delay;
+    task->interval = options.interval;
+    task->callback = std::move(callback);
+    task->should_continue = std::move(should_continue);
+
+    const auto id{ task->id };
+
+    // Counted before the task is visible anywhere, so it can never be released first
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        auto& stripe{ id_stripe(id) };
+        std::lock_guard lock(stripe.mutex);
+        stripe.tasks.emplace(id, task);
+    }
+
+    if (!task->tag.empty()) {
+        auto& stripe{ tag_stripe(task->tag) };
+        std::lock_guard lock(stripe.mutex);
+        stripe.tasks[task->tag].emplace(id, task);
+    }
+
+    if (options.delay.count() > 0 || paused_) {
+        add_timer(std::move(task));
+    }
+    else {
+        enqueue(std::move(task));
+    }
+
+    return id;
+}
+
+void Scheduler::enqueue(TaskPtr task)
+{
+    const auto count{ worker_count_.load(std::memory_order_acquire) };
+    const auto index{
+        current_scheduler == this
+            ? current_worker
+            : next_worker_.fetch_add(1, std::memory_order_relaxed) % count
+    };
+
+    {
+        auto& worker{ *workers_[index] };
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    if (idle_workers_.load(std::memory_order_acquire) == 0) {
+        grow();
+    }
+
+    work_available_.release();
+}
+
+void Scheduler::add_timer(TaskPtr task)
+{
+    {
+        std::lock_guard lock(timer_mutex_);
+        const auto execute_at{ task->execute_at };
+        const auto priority{ task->priority };
+        timers_.push_back({ execute_at, priority, std::move(task) });
+        std::ranges::push_heap(timers_, LATER);
+    }
+
+    timer_cv_.notify_one();
+}
+
+void Scheduler::grow()
+{
+    std::lock_guard lock(grow_mutex_);
+
+    const auto count{ worker_count_.load(std::memory_order_relaxed) };
+    if (!running_ || count >= workers_.size()) {
+        return;
+    }
+
+    workers_[count]->thread = std::thread(&Scheduler::worker_thread, this, count);
+    worker_count_.store(count + 1, std::memory_order_release);
+
+    spdlog::debug("Scheduler grew to {} worker threads", count + 1);
+}
+
+Scheduler::TaskPtr Scheduler::take(const std::size_t self)
+{
+    {
+        // Newest first from our own deque, it is the most likely to still be in cache
+        auto& worker{ *workers_[self] };
+        std::lock_guard lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            auto task{ std::move(worker.tasks.back()) };
+            worker.tasks.pop_back();
+            return task;
+        }
+    }
+
+    const auto count{ worker_count_.load(std::memory_order_acquire) };
+    for (std::size_t i = 1; i < count; ++i) {
+        // Oldest first from the others, so owners and thieves work opposite ends
+        auto& victim{ *workers_[(self + i) % count] };
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            auto task{ std::move(victim.tasks.front()) };
+            victim.tasks.pop_front();
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
 bool Scheduler::cancel(TaskId id)
 {
     if (id == INVALID_TASK_ID) {
         return false;
     }
 
-    std::lock_guard lock(mutex_);
+    const auto task{ find(id) };
+    return task && cancel(task);
+}
 
-    if (!pending_tasks_.contains(id)) {
-        return false;
+bool Scheduler::cancel(const TaskPtr& task)
+{
+    auto expected{ State::Pending };
+    if (task->state.compare_exchange_strong(expected, State::Cancelled, std::memory_order_acq_rel)) {
+        // The timer or a worker still holds the task, they drop it once they see the state
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        unregister(*task);
+        release_outstanding();
+        return true;
     }
 
-    cancelled_tasks_.insert(id);
-    return true;
+    // A running periodic task is cleaned up by its worker instead of being rescheduled
+    expected = State::Running;
+    return task->interval.count() > 0
+        && task->state.compare_exchange_strong(expected, State::Cancelled, std::memory_order_acq_rel);
 }
 
 std::size_t Scheduler::cancel_by_tag(const std::string& tag)
@@ -188,17 +321,26 @@ std::size_t Scheduler::cancel_by_tag(const std::string& tag)
         return 0;
     }
 
-    std::lock_guard lock(mutex_);
+    std::vector<TaskPtr> tasks{};
+    {
+        auto& stripe{ tag_stripe(tag) };
+        std::lock_guard lock(stripe.mutex);
+
+        const auto it{ stripe.tasks.find(tag) };
+        if (it == stripe.tasks.end()) {
+            return 0;
+        }
 
-    const auto it{ tasks_by_tag_.find(tag) };
-    if (it == tasks_by_tag_.end()) {
-        return 0;
+        tasks.reserve(it->second.size());
+        for (const auto& task : it->second | std::views::values) {
+            tasks.push_back(task);
+        }
     }
 
+    // Cancelling unregisters the task, which takes the stripe lock again
     std::size_t count = 0;
-    for (TaskId id : it->second) {
-        if (pending_tasks_.contains(id)) {
-            cancelled_tasks_.insert(id);
+    for (const auto& task : tasks) {
+        if (cancel(task)) {
             ++count;
         }
     }
@@ -208,36 +350,86 @@ std::size_t Scheduler::cancel_by_tag(const std::string& tag)
 
 void Scheduler::cancel_all()
 {
-    std::lock_guard lock(mutex_);
+    for (auto& stripe : id_stripes_) {
+        std::vector<TaskPtr> tasks{};
+        {
+            std::lock_guard lock(stripe.mutex);
+            tasks.reserve(stripe.tasks.size());
+            for (const auto& task : stripe.tasks | std::views::values) {
+                tasks.push_back(task);
+            }
+        }
 
-    for (TaskId id : pending_tasks_) {
-        cancelled_tasks_.insert(id);
+        for (const auto& task : tasks) {
+            cancel(task);
+        }
     }
 }
 
+void Scheduler::unregister(const Task& task)
+{
+    {
+        auto& stripe{ id_stripe(task.id) };
+        std::lock_guard lock(stripe.mutex);
+        stripe.tasks.erase(task.id);
+    }
+
+    if (task.tag.empty()) {
+        return;
+    }
+
+    auto& stripe{ tag_stripe(task.tag) };
+    std::lock_guard lock(stripe.mutex);
+
+    if (const auto it{ stripe.tasks.find(task.tag) }; it != stripe.tasks.end()) {
+        it->second.erase(task.id);
+        if (it->second.empty()) {
+            stripe.tasks.erase(it);
+        }
+    }
+}
+
+void Scheduler::release_outstanding()
+{
+    if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        outstanding_.notify_all();
+    }
+}
+
+Scheduler::TaskPtr Scheduler::find(const TaskId id) const
+{
+    auto& stripe{ id_stripe(id) };
+    std::lock_guard lock(stripe.mutex);
+
+    const auto it{ stripe.tasks.find(id) };
+    return it != stripe.tasks.end() ? it->second : nullptr;
+}
+
+Scheduler::IdStripe& Scheduler::id_stripe(const TaskId id) const
+{
+    return id_stripes_[id % STRIPE_COUNT];
+}
+
+Scheduler::TagStripe& Scheduler::tag_stripe(const std::string& tag) const
+{
+    return tag_stripes_[std::hash<std::string>{}(tag) % STRIPE_COUNT];
+}
+
 bool Scheduler::is_pending(TaskId id) const
 {
-    std::lock_guard lock(mutex_);
-    return pending_tasks_.contains(id) && !cancelled_tasks_.contains(id);
+    const auto task{ find(id) };
+    return task && task->state.load(std::memory_order_acquire) == State::Pending;
 }
 
 bool Scheduler::is_running(TaskId id) const
 {
-    std::lock_guard lock(mutex_);
-    return running_tasks_.contains(id);
+    const auto task{ find(id) };
+    return task && task->state.load(std::memory_order_acquire) == State::Running;
 }
 
 std::size_t Scheduler::pending_count() const
 {
-    std::lock_guard lock(mutex_);
-    std::size_t count{ 0 };
-    for (TaskId id : pending_tasks_) {
-        if (cancelled_tasks_.find(id) == cancelled_tasks_.end()) {
-            ++count;
-        }
-    }
-
-    return count;
+    return pending_.load(std::memory_order_relaxed);
 }
 
 std::size_t Scheduler::pending_count_by_tag(const std::string& tag) const
@@ -246,193 +438,148 @@ std::size_t Scheduler::pending_count_by_tag(const std::string& tag) const
         return 0;
     }
 
-    std::lock_guard lock(mutex_);
+    auto& stripe{ tag_stripe(tag) };
+    std::lock_guard lock(stripe.mutex);
 
-    const auto it{ tasks_by_tag_.find(tag) };
-    if (it == tasks_by_tag_.end()) {
+    const auto it{ stripe.tasks.find(tag) };
+    if (it == stripe.tasks.end()) {
         return 0;
     }
 
-    std::size_t count = 0;
-    for (TaskId id : it->second) {
-        if (pending_tasks_.contains(id) && !cancelled_tasks_.contains(id)) {
-            ++count;
-        }
-    }
-    return count;
+    return static_cast<std::size_t>(std::ranges::count_if(it->second | std::views::values, [](const TaskPtr& task) {
+        return task->state.load(std::memory_order_acquire) == State::Pending;
+    }));
 }
 
 void Scheduler::pause()
 {
+    std::lock_guard lock(timer_mutex_);
     paused_ = true;
 }
 
 void Scheduler::resume()
 {
-    paused_ = false;
+    {
+        std::lock_guard lock(timer_mutex_);
+        paused_ = false;
+    }
+
     timer_cv_.notify_all();
-    worker_cv_.notify_all();
 }
 
 void Scheduler::wait_all()
 {
-    std::unique_lock lock(mutex_);
-    idle_cv_.wait(lock, [this] {
-        return pending_tasks_.empty() && running_tasks_.empty();
-    });
+    for (auto count{ outstanding_.load(std::memory_order_acquire) }; count != 0; count = outstanding_.load(std::memory_order_acquire)) {
+        outstanding_.wait(count, std::memory_order_acquire);
+    }
 }
 
 void Scheduler::timer_thread()
 {
-    while (running_) {
-        std::unique_lock lock(mutex_);
+    std::unique_lock lock(timer_mutex_);
 
-        if (task_queue_.empty()) {
+    while (running_) {
+        if (paused_ || timers_.empty()) {
             timer_cv_.wait(lock, [this] {
-                return !running_ || !task_queue_.empty();
+                return !running_ || (!paused_ && !timers_.empty());
             });
-
-            if (!running_) {
-                break;
-            }
+            continue;
         }
 
-        if (paused_) {
-            timer_cv_.wait(lock, [this] {
-                return !running_ || !paused_;
-            });
-
-            if (!running_) {
-                break;
-            }
+        if (const auto execute_at{ timers_.front().execute_at }; execute_at > std::chrono::steady_clock::now()) {
+            // Woken early by an earlier task, a pause or stop
+            timer_cv_.wait_until(lock, execute_at);
             continue;
         }
 
-        if (task_queue_.empty()) {
+        std::ranges::pop_heap(timers_, LATER);
+        auto task{ std::move(timers_.back().task) };
+        timers_.pop_back();
+
+        if (task->state.load(std::memory_order_acquire) != State::Pending) {
             continue;
         }
 
-        const auto& top_task = task_queue_.top();
-
-        if (auto now = std::chrono::steady_clock::now(); top_task.execute_at <= now) {
-            Task task = std::move(const_cast<Task&>(task_queue_.top()));
-            task_queue_.pop();
-
-            if (cancelled_tasks_.contains(task.id)) {
-                pending_tasks_.erase(task.id);
-                cancelled_tasks_.erase(task.id);
-
-                if (!task.tag.empty()) {
-                    auto tag_it = tasks_by_tag_.find(task.tag);
-                    if (tag_it != tasks_by_tag_.end()) {
-                        tag_it->second.erase(task.id);
-                        if (tag_it->second.empty()) {
-                            tasks_by_tag_.erase(tag_it);
-                        }
-                    }
-                }
-                continue;
-            }
+        lock.unlock();
+        enqueue(std::move(task));
+        lock.lock();
+    }
+}
 
-            ready_queue_.push(std::move(task));
-            worker_cv_.notify_one();
+void Scheduler::worker_thread(const std::size_t index)
+{
+    current_scheduler = this;
+    current_worker = index;
+
+    while (true) {
+        idle_workers_.fetch_add(1, std::memory_order_acq_rel);
+        work_available_.acquire();
+        idle_workers_.fetch_sub(1, std::memory_order_acq_rel);
+
+        // Every queued task comes with a permit and is pushed before its permit is released, so while
+        // running there is always a task for the one we hold. A scan can still miss it when it lands
+        // on a deque we already passed, keep scanning instead of dropping the permit. Once stopping,
+        // an empty scan means the permit was one of those stop() adds.
+        TaskPtr task{};
+        while (!(task = take(index)) && running_) {
+            std::this_thread::yield();
         }
-        else {
-            auto wait_duration = top_task.execute_at - now;
-            timer_cv_.wait_for(lock, wait_duration, [this] {
-                return !running_ || paused_;
-            });
+
+        if (!task) {
+            break;
         }
+
+        run(task);
     }
+
+    current_scheduler = nullptr;
 }
 
-void Scheduler::worker_thread()
+void Scheduler::run(const TaskPtr& task)
 {
-    while (running_) {
-        Task task;
-
-        {
-            std::unique_lock lock(mutex_);
+    auto expected{ State::Pending };
+    if (!task->state.compare_exchange_strong(expected, State::Running, std::memory_order_acq_rel)) {
+        return;
+    }
 
-            worker_cv_.wait(lock, [this] {
-                return !running_ || !ready_queue_.empty();
-            });
+    pending_.fetch_sub(1, std::memory_order_relaxed);
 
-            if (!running_ && ready_queue_.empty()) {
-                break;
-            }
+    try {
+        task->callback();
+    }
+    catch (const std::exception& e) {
+        spdlog::error("Scheduler task {} threw exception: {}", task->id, e.what());
+    }
+    catch (...) {
+        spdlog::error("Scheduler task {} threw unknown exception", task->id);
+    }
 
-            if (ready_queue_.empty()) {
-                continue;
-            }
+    const bool should_reschedule{
+        task->interval.count() > 0 &&
+        running_ &&
+        (!task->should_continue || *task->should_continue)
+    };
 
-            task = std::move(ready_queue_.front());
-            ready_queue_.pop();
+    if (should_reschedule) {
+        task->execute_at = std::chrono::steady_clock::now() + task->interval;
 
-            pending_tasks_.erase(task.id);
-            running_tasks_.insert(task.id);
-            ++active_tasks_;
-        }
+        // Counted first, a cancel right after the exchange already subtracts it
+        pending_.fetch_add(1, std::memory_order_relaxed);
 
-        try {
-            task.callback();
-        }
-        catch (const std::exception& e) {
-            spdlog::error("Scheduler task {} threw exception: {}", task.id, e.what());
-        }
-        catch (...) {
-            spdlog::error("Scheduler task {} threw unknown exception", task.id);
+        // Fails when the task was cancelled while it ran
+        expected = State::Running;
+        if (task->state.compare_exchange_strong(expected, State::Pending, std::memory_order_acq_rel)) {
+            add_timer(task);
+            return;
         }
 
-        {
-            std::lock_guard lock(mutex_);
-
-            running_tasks_.erase(task.id);
-            --active_tasks_;
-
-            if (!task.tag.empty()) {
-                if (auto tag_it = tasks_by_tag_.find(task.tag); tag_it != tasks_by_tag_.end()) {
-                    tag_it->second.erase(task.id);
-                    if (tag_it->second.empty()) {
-                        tasks_by_tag_.erase(tag_it);
-                    }
-                }
-            }
-
-            const bool should_reschedule{
-                task.interval.count() > 0 &&
-                !cancelled_tasks_.contains(task.id) &&
-                (!task.should_continue || *task.should_continue)
-            };
-
-            if (should_reschedule) {
-                TaskId new_id = generate_id();
-
-                Task new_task{
-                    .id = new_id,
-                    .tag = task.tag,
-                    .priority = task.priority,
-                    .execute_at = std::chrono::steady_clock::now() + task.interval,
-                    .interval = task.interval,
-                    .callback = std::move(task.callback),
-                    .should_continue = std::move(task.should_continue)
-                };
-
-                pending_tasks_.insert(new_id);
-                if (!new_task.tag.empty()) {
-                    tasks_by_tag_[new_task.tag].insert(new_id);
-                }
-
-                task_queue_.push(std::move(new_task));
-                timer_cv_.notify_one();
-            }
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+    }
 
-            cancelled_tasks_.erase(task.id);
+    expected = State::Running;
+    task->state.compare_exchange_strong(expected, State::Done, std::memory_order_acq_rel);
 
-            if (pending_tasks_.empty() && running_tasks_.empty()) {
-                idle_cv_.notify_all();
-            }
-        }
-    }
+    unregister(*task);
+    release_outstanding();
 }
 }
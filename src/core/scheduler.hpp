@@ -1,15 +1,16 @@
 #pragma once
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <semaphore>
 #include <string>
 #include <thread>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace core {
@@ -31,9 +32,15 @@ struct TaskOptions {
     std::chrono::milliseconds interval{ 0 };
 };
 
+// Work-stealing pool. Each worker owns a deque: tasks scheduled from a worker go to the back of its
+// own deque, everything else is spread over the workers, and idle workers steal from the front of
+// the others. Delayed and periodic tasks wait in a separate timer heap until due. The pool starts
+// with one worker and adds one whenever a task is queued while every worker is busy, up to
+// max_threads. Task state lives in the task itself, the id and tag indexes are striped so queries
+// and cancellation only lock the stripe they touch.
 class Scheduler {
 public:
-    explicit Scheduler(std::size_t num_threads = std::thread::hardware_concurrency());
+    explicit Scheduler(std::size_t max_threads = std::thread::hardware_concurrency());
     ~Scheduler();
 
     Scheduler(const Scheduler&) = delete;
@@ -48,6 +55,7 @@ public:
         const std::string& tag = "",
         TaskPriority priority = TaskPriority::Normal
     );
+    // The task keeps its id across runs, cancelling it while it runs stops the next run
     TaskId schedule_periodic(
         std::function<void()> callback,
         std::chrono::milliseconds interval,
@@ -70,6 +78,7 @@ public:
     [[nodiscard]] bool is_running(TaskId id) const;
     [[nodiscard]] std::size_t pending_count() const;
     [[nodiscard]] std::size_t pending_count_by_tag(const std::string& tag) const;
+    [[nodiscard]] std::size_t worker_count() const { return worker_count_.load(std::memory_order_acquire); }
 
     void pause();
     void resume();
@@ -78,6 +87,13 @@ public:
     void wait_all();
 
 private:
+    enum class State : std::uint8_t {
+        Pending,
+        Running,
+        Cancelled,
+        Done
+    };
+
     struct Task {
         TaskId id;
         std::string tag;
@@ -86,42 +102,84 @@ private:
         std::chrono::milliseconds interval;
         std::function<void()> callback;
         std::shared_ptr<std::atomic<bool>> should_continue;
+        std::atomic<State> state{ State::Pending };
+    };
 
-        bool operator>(const Task& other) const
-        {
-            if (execute_at != other.execute_at) {
-                return execute_at > other.execute_at;
-            }
+    using TaskPtr = std::shared_ptr<Task>;
 
-            return static_cast<std::int8_t>(priority) > static_cast<std::int8_t>(other.priority);
-        }
+    struct TimerEntry {
+        std::chrono::steady_clock::time_point execute_at;
+        TaskPriority priority;
+        TaskPtr task;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<TaskPtr> tasks;
+        std::thread thread;
+    };
+
+    static constexpr std::size_t STRIPE_COUNT{ 16 };
+
+    struct IdStripe {
+        mutable std::mutex mutex;
+        std::unordered_map<TaskId, TaskPtr> tasks;
+    };
+
+    struct TagStripe {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, std::unordered_map<TaskId, TaskPtr>> tasks;
     };
 
-    void worker_thread();
-    void timer_thread();
     TaskId generate_id();
+    TaskId submit(
+        std::function<void()> callback,
+        const TaskOptions& options,
+        std::shared_ptr<std::atomic<bool>> should_continue
+    );
+
+    // Hands a due task to a worker deque, growing the pool if nobody is idle
+    void enqueue(TaskPtr task);
+    void add_timer(TaskPtr task);
+    void grow();
+    [[nodiscard]] TaskPtr take(std::size_t self);
+
+    bool cancel(const TaskPtr& task);
+    void unregister(const Task& task);
+    void release_outstanding();
+
+    [[nodiscard]] TaskPtr find(TaskId id) const;
+    [[nodiscard]] IdStripe& id_stripe(TaskId id) const;
+    [[nodiscard]] TagStripe& tag_stripe(const std::string& tag) const;
+
+    void worker_thread(std::size_t index);
+    void timer_thread();
+    void run(const TaskPtr& task);
 
 private:
-    std::priority_queue<Task, std::vector<Task>, std::greater<Task>> task_queue_;
-    std::unordered_set<TaskId> cancelled_tasks_;
-    std::unordered_set<TaskId> pending_tasks_;
-    std::unordered_set<TaskId> running_tasks_;
-    std::unordered_map<std::string, std::unordered_set<TaskId>> tasks_by_tag_;
+    mutable std::array<IdStripe, STRIPE_COUNT> id_stripes_;
+    mutable std::array<TagStripe, STRIPE_COUNT> tag_stripes_;
 
-    std::queue<Task> ready_queue_;
+    // Slots are allocated up front so thieves never race a resize, threads start on demand
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::size_t> worker_count_;
+    std::atomic<std::size_t> idle_workers_;
+    std::atomic<std::size_t> next_worker_;
+    std::mutex grow_mutex_;
 
-    mutable std::mutex mutex_;
-    std::condition_variable timer_cv_;
-    std::condition_variable worker_cv_;
+    // One permit per queued task, plus one per worker on stop
+    std::counting_semaphore<> work_available_;
 
-    std::vector<std::thread> workers_;
+    std::vector<TimerEntry> timers_;
+    std::mutex timer_mutex_;
+    std::condition_variable timer_cv_;
     std::thread timer_thread_;
 
     std::atomic<bool> running_;
     std::atomic<bool> paused_;
     std::atomic<TaskId> next_id_;
-    std::atomic<std::size_t> active_tasks_;
-
-    std::condition_variable idle_cv_;
+    std::atomic<std::size_t> pending_;
+    // Pending plus running, wait_all() blocks until it drops to zero
+    std::atomic<std::size_t> outstanding_;
 };
 }
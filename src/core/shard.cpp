@@ -0,0 +1,263 @@
+#include "shard.hpp"
+
+#include <ranges>
+#include <spdlog/spdlog.h>
+
+#include "../network/packet_dispatch.hpp"
+#include "../network/received_packet.hpp"
+#include "../scripting/bindings/command_bindings.hpp"
+#include "../scripting/bindings/event_bindings.hpp"
+#include "../scripting/bindings/logger_bindings.hpp"
+#include "../scripting/bindings/packet_bindings.hpp"
+#include "../scripting/bindings/scheduler_bindings.hpp"
+#include "../scripting/bindings/player_bindings.hpp"
+#include "../scripting/bindings/world_bindings.hpp"
+#include "../scripting/bindings/world_data_bindings.hpp"
+#include "../scripting/bindings/item_bindings.hpp"
+
+namespace core {
+Shard::Shard(
+    const std::size_t index,
+    Config& config,
+    network::Server& server,
+    std::shared_ptr<Scheduler> scheduler,
+    EventLoop* inline_event_loop
+)
+    : index_{ index }
+    , config_{ config }
+    , server_{ server }
+    , own_event_loop_{ inline_event_loop ? nullptr : std::make_unique<EventLoop>(config.get_loop_config()) }
+    , event_loop_{ inline_event_loop ? *inline_event_loop : *own_event_loop_ }
+    , executor_{ event_loop_ }
+    , running_{ false }
+    , load_{ 0 }
+    , current_session_{ nullptr }
+    , scheduler_{ std::move(scheduler) }
+{
+    connection_handler_ = std::make_unique<handlers::ConnectionHandler>(dispatcher_, server_, config_);
+    forwarding_handler_ = std::make_unique<handlers::ForwardingHandler>(dispatcher_);
+    world_handler_ = std::make_unique<handlers::WorldHandler>(dispatcher_);
+    command_handler_ = std::make_unique<command::CommandHandler>(config_, dispatcher_, scheduler_);
+
+    script_engine_ = std::make_unique<scripting::LuaEngine>();
+
+    script_scheduler_ = std::make_unique<scripting::ScriptScheduler>(*script_engine_);
+
+    script_event_bridge_ = std::make_unique<scripting::ScriptEventBridge>(
+        dispatcher_,
+        *script_engine_
+    );
+
+    script_engine_->register_binding(std::make_unique<scripting::bindings::CommandBindings>(*command_handler_, *this, dispatcher_, scheduler_));
+    script_engine_->register_binding(std::make_unique<scripting::bindings::EventBindings>(*script_event_bridge_));
+    script_engine_->register_binding(std::make_unique<scripting::bindings::LoggerBindings>());
+    script_engine_->register_binding(std::make_unique<scripting::bindings::PacketBindings>(*this));
+    script_engine_->register_binding(std::make_unique<scripting::bindings::SchedulerBindings>(*script_scheduler_, *this));
+    script_engine_->register_binding(std::make_unique<scripting::bindings::PlayerBindings>());
+    script_engine_->register_binding(std::make_unique<scripting::bindings::WorldBindings>(*this));
+    script_engine_->register_binding(std::make_unique<scripting::bindings::WorldDataBindings>());
+    script_engine_->register_binding(std::make_unique<scripting::bindings::ItemBindings>());
+
+    script_loader_ = std::make_unique<scripting::ScriptLoader>(*script_engine_, "scripts");
+    script_loader_->load_all();
+}
+
+Shard::~Shard()
+{
+    stop();
+
+    for (const auto& message : inbound_) {
+        if (message.packet) {
+            enet_packet_destroy(message.packet);
+        }
+    }
+
+    for (const auto& session : sessions_ | std::views::values) {
+        event_loop_.remove_socket(session->upstream().socket());
+    }
+}
+
+void Shard::start()
+{
+    if (!own_event_loop_ || running_.exchange(true)) {
+        return;
+    }
+
+    thread_ = std::thread{ &Shard::run, this };
+}
+
+void Shard::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    event_loop_.wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Shard::run()
+{
+    spdlog::info("Shard {} started", index_);
+
+    while (running_) {
+        process();
+
+        const auto deadline{ next_deadline() };
+        event_loop_.wait(deadline.value_or(EventLoop::Clock::time_point::max()));
+    }
+
+    spdlog::info("Shard {} stopped", index_);
+}
+
+void Shard::post(network::SessionMessage message)
+{
+    if (message.type == network::SessionMessage::Type::Connect) {
+        load_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::scoped_lock lock{ inbound_mutex_ };
+        inbound_.push_back(std::move(message));
+    }
+
+    if (own_event_loop_) {
+        event_loop_.wake();
+    }
+}
+
+void Shard::execute(std::function<void()> task)
+{
+    executor_.post(std::move(task));
+}
+
+void Shard::wake()
+{
+    event_loop_.wake();
+}
+
+void Shard::process()
+{
+    {
+        std::scoped_lock lock{ inbound_mutex_ };
+        inbound_swap_.swap(inbound_);
+    }
+
+    for (auto& [type, session, packet, channel] : inbound_swap_) {
+        switch (type) {
+        case network::SessionMessage::Type::Connect:
+            on_connect(session);
+            break;
+        case network::SessionMessage::Type::Receive:
+            on_receive(*session, packet, channel);
+            break;
+        case network::SessionMessage::Type::Disconnect:
+            on_disconnect(*session);
+            break;
+        }
+    }
+
+    inbound_swap_.clear();
+
+    // Work handed over by scheduler threads and the web server, before the upstream hosts are serviced
+    // so anything it writes goes out with this round's flush
+    executor_.drain();
+
+    for (const auto& session : sessions_ | std::views::values) {
+        current_session_ = session.get();
+        session->upstream().process();
+    }
+
+    current_session_ = nullptr;
+
+    script_scheduler_->update(EventLoop::Clock::now());
+
+    close_sessions();
+
+    for (const auto& session : sessions_ | std::views::values) {
+        session->upstream().flush();
+    }
+
+    // Everything received this round has been forwarded, observers get it now
+    dispatcher_.flush_observers();
+}
+
+std::optional<EventLoop::Clock::time_point> Shard::next_deadline() const
+{
+    return script_scheduler_->next_deadline();
+}
+
+std::shared_ptr<network::Session> Shard::active_session() const
+{
+    if (current_session_) {
+        return current_session_->shared_from_this();
+    }
+
+    // Gone if the session closed since the timer was scheduled, the script's send fails then
+    if (const auto id{ script_scheduler_->running_session() }; id != scripting::NO_SESSION) {
+        return find_session(id);
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<network::Session> Shard::find_session(const std::uint32_t id) const
+{
+    const auto it{ sessions_.find(id) };
+    return it != sessions_.end() ? it->second : nullptr;
+}
+
+void Shard::on_connect(const std::shared_ptr<network::Session>& session)
+{
+    sessions_.emplace(session->id(), session);
+    event_loop_.add_socket(session->upstream().socket());
+
+    spdlog::info("Session {} opened on shard {} ({} active)", session->id(), index_, sessions_.size());
+
+    current_session_ = session.get();
+
+    const event::ConnectionEvent evt{ event::Type::ClientConnect, session.get() };
+    dispatcher_.dispatch(evt);
+
+    current_session_ = nullptr;
+}
+
+void Shard::on_receive(network::Session& session, ENetPacket* packet, const enet_uint8 channel)
+{
+    network::ReceivedPacket received{ packet, channel };
+
+    current_session_ = &session;
+
+    network::dispatch_received(dispatcher_, config_.get_log_config(), event::Direction::ServerBound, session, received);
+
+    current_session_ = nullptr;
+}
+
+void Shard::on_disconnect(network::Session& session)
+{
+    current_session_ = &session;
+
+    const event::ConnectionEvent evt{ event::Type::ClientDisconnect, &session };
+    dispatcher_.dispatch(evt);
+
+    current_session_ = nullptr;
+}
+
+void Shard::close_sessions()
+{
+    std::erase_if(sessions_, [this](const auto& entry) {
+        const auto& session{ entry.second };
+        if (!session->is_closed()) {
+            return false;
+        }
+
+        event_loop_.remove_socket(session->upstream().socket());
+        load_.fetch_sub(1, std::memory_order_relaxed);
+
+        spdlog::info("Session {} closed on shard {} ({} active)", session->id(), index_, sessions_.size() - 1);
+        return true;
+    });
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "config.hpp"
+#include "event_loop.hpp"
+#include "loop_executor.hpp"
+#include "scheduler.hpp"
+#include "handlers/connection_handler.hpp"
+#include "handlers/forwarding_handler.hpp"
+#include "handlers/world_handler.hpp"
+#include "../command/command_handler.hpp"
+#include "../network/server.hpp"
+#include "../network/session.hpp"
+#include "../network/session_worker.hpp"
+#include "../scripting/lua_engine.hpp"
+#include "../scripting/script_event_bridge.hpp"
+#include "../scripting/script_loader.hpp"
+#include "../scripting/script_scheduler.hpp"
+#include "../utils/types.hpp"
+
+namespace core {
+// Worker for a group of sessions. A shard owns everything its sessions run on: the upstream
+// client hosts, the dispatcher with its handlers and its own Lua VM, so shards never share
+// mutable state with each other. Threaded shards run their own EventLoop, an inline shard is
+// driven by Core::run on the main thread.
+class Shard final : public network::ISessionWorker, public utils::types::Immobile {
+public:
+    Shard(
+        std::size_t index,
+        Config& config,
+        network::Server& server,
+        std::shared_ptr<Scheduler> scheduler,
+        EventLoop* inline_event_loop = nullptr
+    );
+    ~Shard() override;
+
+    void start();
+    void stop();
+
+    // Dispatches messages from the acceptor, services the upstream hosts and ticks script timers.
+    void process();
+
+    [[nodiscard]] std::optional<EventLoop::Clock::time_point> next_deadline() const;
+
+    [[nodiscard]] event::Dispatcher& dispatcher() override { return dispatcher_; }
+    [[nodiscard]] std::size_t load() const override { return load_.load(std::memory_order_relaxed); }
+
+    void post(network::SessionMessage message) override;
+    void execute(std::function<void()> task) override;
+    void wake() override;
+
+    [[nodiscard]] std::shared_ptr<network::Session> active_session() const override;
+    [[nodiscard]] std::shared_ptr<network::Session> find_session(std::uint32_t id) const override;
+
+private:
+    void run();
+
+    void on_connect(const std::shared_ptr<network::Session>& session);
+    void on_receive(network::Session& session, ENetPacket* packet, enet_uint8 channel);
+    void on_disconnect(network::Session& session);
+
+    void close_sessions();
+
+private:
+    std::size_t index_;
+    Config& config_;
+    network::Server& server_;
+
+    std::unique_ptr<EventLoop> own_event_loop_;
+    EventLoop& event_loop_;
+    LoopExecutor executor_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    std::mutex inbound_mutex_;
+    std::vector<network::SessionMessage> inbound_;
+    std::vector<network::SessionMessage> inbound_swap_;
+    std::atomic<std::size_t> load_;
+
+    std::unordered_map<std::uint32_t, std::shared_ptr<network::Session>> sessions_;
+    network::Session* current_session_;
+
+    event::Dispatcher dispatcher_;
+    std::shared_ptr<Scheduler> scheduler_;
+
+    std::unique_ptr<handlers::ConnectionHandler> connection_handler_;
+    std::unique_ptr<handlers::ForwardingHandler> forwarding_handler_;
+    std::unique_ptr<handlers::WorldHandler> world_handler_;
+    std::unique_ptr<command::CommandHandler> command_handler_;
+
+    std::unique_ptr<scripting::LuaEngine> script_engine_;
+    std::unique_ptr<scripting::ScriptScheduler> script_scheduler_;
+    std::unique_ptr<scripting::ScriptEventBridge> script_event_bridge_;
+    std::unique_ptr<scripting::ScriptLoader> script_loader_;
+};
+}
@@ -5,23 +5,16 @@
 #include <spdlog/spdlog.h>
 
 #include "../utils/text_parse.hpp"
+#include "../utils/text_parse_view.hpp"
 // ReSharper disable once CppUnusedIncludeDirective
 #include "../utils/formatter/text_parse_formatter.hpp"
 
 namespace core {
-WebServer::WebServer(
-    Config& config,
-    event::Dispatcher& dispatcher,
-    network::Client& client,
-    network::Server& server
-)
+WebServer::WebServer(Config& config, network::Server& server)
     : config_{ config }
-    , dispatcher_{ dispatcher }
-    , client_{ client }
     , server_{ server }
     , dns_resolver_{ network::create_dns_provider(config_.get_client_config().dns_server) }
     , https_server_{ "./resources/cert.pem", "./resources/key.pem" }
-    , pending_port_{ 65535 }
 {
     setup_server();
 
@@ -30,9 +23,6 @@ WebServer::WebServer(
         return;
     }
 
-    dispatcher_.appendListener(event::Type::ClientConnect, [this](const event::Event& e) { on_client_connect(e); });
-    dispatcher_.appendListener(event::Type::ClientDisconnect, [this](const event::Event& e) { on_client_disconnect(e); });
-
     spdlog::info("HTTPS server listening on port 443");
     server_thread_ = std::thread{ &WebServer::listen_internal, this };
 }
@@ -141,20 +131,20 @@ void WebServer::listen_internal()
             return true;
         }
 
-        utils::TextParse text_parse{ response->body };
-        if (text_parse.empty()) {
+        const utils::TextParseView response_data{ response->body };
+        if (response_data.empty()) {
             spdlog::error("Failed to parse server_data.php response");
             res.status = 500;
             return true;
         }
 
-        spdlog::info("Original server_data.php response:\n{}", text_parse);
+        spdlog::info("Original server_data.php response:\n{}", response_data);
 
-        pending_address_ = text_parse.get("server", 0);
+        network::Route route{ response_data.get("server", 0), 65535 };
 
-        std::string port{ text_parse.get("port", 0) };
+        const auto port{ response_data.get<std::string_view>("port", 0) };
         if (
-            auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), pending_port_);
+            auto [ptr, ec] = std::from_chars(port.data(), port.data() + port.size(), route.port);
             ec != std::errc{}
         ) {
             spdlog::error("Failed to parse port from server_data.php response");
@@ -162,6 +152,15 @@ void WebServer::listen_internal()
             return true;
         }
 
+        // The Growtopia client logs in with the meta it gets here, so the proxy hands out its own
+        // token and swaps the real meta back in once the login shows which route it belongs to
+        route.meta = response_data.get("meta", 0);
+        const auto meta_token{ server_.routes().make_meta_token() };
+        server_.routes().push(network::RouteTable::meta_key(meta_token), std::move(route));
+
+        // Only the rewritten response needs an owning copy
+        utils::TextParse text_parse{ response_data.to_owned() };
+        text_parse.set("meta", { meta_token });
         text_parse.set("server", { "127.0.0.1" });
         text_parse.set("port", { std::to_string(config_.get_server_config().port) });
         text_parse.set("type2", { "1" });
@@ -174,24 +173,4 @@ void WebServer::listen_internal()
 
     https_server_.listen_after_bind();
 }
-
-void WebServer::on_client_connect(const event::Event& e)
-{
-    if (pending_port_ == 65535) {
-        return;
-    }
-
-    spdlog::info("Connecting to Growtopia server at {}:{}", pending_address_, pending_port_);
-
-    client_.connect(pending_address_, pending_port_);
-
-    pending_address_.clear();
-    pending_port_ = 65535;
-}
-
-void WebServer::on_client_disconnect(const event::Event& e)
-{
-    pending_address_.clear();
-    pending_port_ = 65535;
-}
 }
@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace event {
+enum class Type : uint32_t;
+
+// Counters of one listener, identified by the tag it was registered with.
+struct ListenerStats {
+    std::string tag;
+    Type type;
+    int8_t priority;
+
+    std::uint64_t calls{ 0 };
+    std::uint64_t cancels{ 0 };
+    std::chrono::nanoseconds total{ 0 };
+    std::chrono::nanoseconds max{ 0 };
+
+    [[nodiscard]] double cancel_rate() const
+    {
+        return calls ? static_cast<double>(cancels) / static_cast<double>(calls) : 0.0;
+    }
+};
+
+// Per dispatcher listener timings. Listeners always get a stats slot, but nothing is measured until
+// profiling is enabled, a disabled profiler only costs the enabled() check per dispatch.
+class DispatchProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    [[nodiscard]] bool enabled() const { return enabled_; }
+    void set_enabled(const bool enabled) { enabled_ = enabled; }
+
+    [[nodiscard]] std::shared_ptr<ListenerStats> track(std::string tag, const Type type, const int8_t priority)
+    {
+        auto stats{ std::make_shared<ListenerStats>(std::move(tag), type, priority) };
+        stats_.push_back(stats);
+        return stats;
+    }
+
+    // Drops the stats of a removed listener, so subscribing and unsubscribing in a loop does not grow
+    // the profiler. A dispatch still running the listener keeps its own reference.
+    void untrack(const ListenerStats* stats)
+    {
+        std::erase_if(stats_, [stats](const auto& tracked) { return tracked.get() == stats; });
+    }
+
+    // Times one listener call and whether it is the one that canceled the event.
+    template <typename Event, typename Func>
+    static void invoke(ListenerStats& stats, const Event& e, Func&& func)
+    {
+        const bool was_canceled{ e.canceled };
+        const auto start{ Clock::now() };
+
+        std::forward<Func>(func)();
+
+        const auto elapsed{ std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start) };
+        ++stats.calls;
+        stats.total += elapsed;
+        stats.max = std::max(stats.max, elapsed);
+
+        if (!was_canceled && e.canceled) {
+            ++stats.cancels;
+        }
+    }
+
+    // Listeners that are still registered.
+    [[nodiscard]] std::vector<ListenerStats> snapshot() const
+    {
+        std::vector<ListenerStats> snapshot{};
+        snapshot.reserve(stats_.size());
+
+        for (const auto& stats : stats_) {
+            snapshot.push_back(*stats);
+        }
+
+        std::ranges::sort(snapshot, std::ranges::greater{}, &ListenerStats::total);
+        return snapshot;
+    }
+
+    void reset()
+    {
+        for (const auto& stats : stats_) {
+            stats->calls = 0;
+            stats->cancels = 0;
+            stats->total = {};
+            stats->max = {};
+        }
+    }
+
+private:
+    bool enabled_{ false };
+    std::vector<std::shared_ptr<ListenerStats>> stats_;
+};
+}
@@ -1,8 +1,9 @@
 #pragma once
-#include <eventpp/eventdispatcher.h>
+#include <array>
+#include <atomic>
+#include <iterator>
 #include <span>
 #include <memory>
-#include <map>
 #include <vector>
 #include <cstddef>
 #include <cstdint>
@@ -10,10 +11,21 @@
 #include <limits>
 #include <utility>
 #include <algorithm>
+#include <string>
+#include <exception>
+#include <enet/enet.h>
+#include <spdlog/spdlog.h>
 
+#include "dispatch_profiler.hpp"
 #include "../packet/payload.hpp"
 #include "../packet/packet_id.hpp"
 #include "../packet/packet_helper.hpp"
+#include "../utils/serial_executor.hpp"
+
+namespace network {
+class ReceivedPacket;
+class Session;
+}
 
 namespace event {
 struct Priority {
@@ -59,13 +71,20 @@ constexpr packet::PacketId packet_id_from_type(const Type t) {
     return static_cast<packet::PacketId>(static_cast<uint32_t>(t) - packet_event_offset());
 }
 
+constexpr Type raw_packet_type(const Direction direction) {
+    return direction == Direction::ClientBound ? Type::ClientBoundPacket : Type::ServerBoundPacket;
+}
+
 struct Event {
     Type type;
     mutable bool canceled;
+    // Session the event originated from, null for events not tied to a player connection
+    network::Session* session;
 
-    explicit Event(const Type t)
+    explicit Event(const Type t, network::Session* s = nullptr)
         : type{ t }
         , canceled{ false }
+        , session{ s }
     {
 
     }
@@ -76,15 +95,31 @@ struct Event {
 
 
 struct ConnectionEvent : Event {
-    explicit ConnectionEvent(const Type t) : Event{ t } { }
+    explicit ConnectionEvent(const Type t, network::Session* s = nullptr) : Event{ t, s } { }
 };
 
 struct RawPacketEvent : Event {
     std::span<const std::byte> data;
-
-    RawPacketEvent(const Type t, std::span<const std::byte> d)
-        : Event{ t }
+    // ENet packet backing data, lets listeners forward it without a copy
+    network::ReceivedPacket* packet;
+    // Channel and ENet delivery flags the packet arrived with, forwarding reuses them so unreliable
+    // updates are not queued behind reliable traffic on the other side
+    int channel;
+    std::uint32_t flags;
+
+    RawPacketEvent(
+        const Type t,
+        std::span<const std::byte> d,
+        network::Session* s = nullptr,
+        network::ReceivedPacket* p = nullptr,
+        const int c = 0,
+        const std::uint32_t f = ENET_PACKET_FLAG_RELIABLE
+    )
+        : Event{ t, s }
         , data{ d }
+        , packet{ p }
+        , channel{ c }
+        , flags{ f }
     { }
 };
 
@@ -126,9 +161,10 @@ struct TypedPacketEvent : Event {
 
     TypedPacketEvent(
         Direction dir,
-        std::shared_ptr<packet::IPacket> pkt
+        std::shared_ptr<packet::IPacket> pkt,
+        network::Session* s = nullptr
     )
-        : Event{ packet_event_type(PacketTypeId) }
+        : Event{ packet_event_type(PacketTypeId), s }
         , direction{ dir }
         , packet{ std::move(pkt) }
     { }
@@ -156,76 +192,393 @@ struct TypedPacketEvent : Event {
     }
 };
 
+// What an observer gets once a packet has been forwarded. Everything in it is a private copy, it no
+// longer points into the ENet packet, which may only be touched by the thread that received it.
+struct ObservedPacket {
+    Type type;
+    Direction direction;
+    std::uint32_t session_id;
+    // Decoded copy of the packet for packet event types, null for the raw packet types
+    std::shared_ptr<const packet::IPacket> packet;
+    // Received bytes for the raw packet types
+    utils::SharedBytes data;
 
-struct EventPolicies {
-    static Type getEvent(const Event& e) { return e.type; }
-    static bool canContinueInvoking(const Event& e) { return !e.canceled; }
+    template<typename T>
+    [[nodiscard]] std::shared_ptr<const T> get() const
+    {
+        if (packet && packet->id() == T::ID) {
+            return std::static_pointer_cast<const T>(packet);
+        }
+        return nullptr;
+    }
 };
 
-using BaseDispatcher = eventpp::EventDispatcher<
-    Type,
-    void(const Event&),
-    EventPolicies
->;
 
 class PriorityEventDispatcher {
 public:
-    using Handle = BaseDispatcher::Handle;
+    // Identifies a listener for removeListener, 0 is never handed out
+    using Handle = std::uint64_t;
     using Callback = std::function<void(const Event&)>;
+    using ObserverCallback = std::function<void(const ObservedPacket&)>;
+
+    // The tag names the listener in profiler output, e.g. "WorldHandler::send_map_data"
+    Handle appendListener(
+        const Type event,
+        Callback callback,
+        const int8_t priority = Priority::Normal,
+        std::string tag = {}
+    ) {
+        const auto index{ slot_index(event) };
+        if (index == INVALID_SLOT) {
+            return 0;
+        }
+
+        auto& slot{ slots_[index] };
+        auto listeners{ slot ? std::make_shared<ListenerList>(*slot) : std::make_shared<ListenerList>() };
+
+        // Equal priorities keep subscription order
+        const auto it{ std::ranges::upper_bound(*listeners, priority, {}, [](const auto& listener) {
+            return listener->priority;
+        }) };
+
+        const auto handle{ next_handle_++ };
+        if (tag.empty()) {
+            tag = "listener#" + std::to_string(handle);
+        }
+
+        listeners->insert(it, std::make_shared<Listener>(
+            handle,
+            priority,
+            std::move(callback),
+            profiler_.track(std::move(tag), event, priority)
+        ));
+        slot = std::move(listeners);
+
+        return handle;
+    }
+
+    Handle prependListener(const Type event, Callback callback, std::string tag = {})
+    {
+        return appendListener(event, std::move(callback), Priority::Highest, std::move(tag));
+    }
+
+    // Typed subscriptions. Events of a packet type are always TypedPacketEvent<Id> and the raw packet
+    // types are always RawPacketEvent, so the handler receives the concrete event without RTTI and
+    // only for the requested direction.
+    template <packet::PacketId Id, typename Handler>
+    Handle on(
+        const Direction direction,
+        Handler&& handler,
+        const int8_t priority = Priority::Normal,
+        std::string tag = {}
+    ) {
+        return appendListener(
+            packet_event_type(Id),
+            [direction, handler = std::forward<Handler>(handler)](const Event& e) {
+                const auto& evt{ static_cast<const TypedPacketEvent<Id>&>(e) };
+                if (evt.direction == direction) {
+                    handler(evt);
+                }
+            },
+            priority,
+            std::move(tag)
+        );
+    }
 
-    Handle appendListener(const Type event, const Callback& callback, const int8_t priority = Priority::Normal)
+    template <packet::PacketId Id, typename Handler>
+    Handle on(Handler&& handler, const int8_t priority = Priority::Normal, std::string tag = {})
     {
-        auto& entries = handles_[event];
+        return appendListener(
+            packet_event_type(Id),
+            [handler = std::forward<Handler>(handler)](const Event& e) {
+                handler(static_cast<const TypedPacketEvent<Id>&>(e));
+            },
+            priority,
+            std::move(tag)
+        );
+    }
 
-        for (auto it = entries.begin(); it != entries.end(); ++it) {
-            if (it->priority > priority) {
-                auto handle = dispatcher_.insertListener(event, callback, it->handle);
-                entries.insert(it, {priority, handle});
-                return handle;
-            }
+    template <typename Handler>
+    Handle on_raw_packet(
+        const Direction direction,
+        Handler&& handler,
+        const int8_t priority = Priority::Normal,
+        std::string tag = {}
+    ) {
+        return appendListener(
+            raw_packet_type(direction),
+            [handler = std::forward<Handler>(handler)](const Event& e) {
+                handler(static_cast<const RawPacketEvent&>(e));
+            },
+            priority,
+            std::move(tag)
+        );
+    }
+
+    // Observers never see the live event, they cannot cancel or modify it. They get an ObservedPacket
+    // on the dispatcher's background thread after the packet has been forwarded, see defer(), so
+    // they have to be safe to run alongside the shard thread. Removing one waits until it is no
+    // longer running.
+    Handle appendObserver(const Type event, ObserverCallback callback)
+    {
+        const auto index{ slot_index(event) };
+        if (index == INVALID_SLOT) {
+            return 0;
+        }
+
+        if (!executor_) {
+            executor_ = std::make_unique<utils::SerialExecutor>();
         }
 
-        auto handle = dispatcher_.appendListener(event, callback);
-        entries.push_back({ priority, handle });
+        auto& slot{ observer_slots_[index] };
+        auto observers{ slot ? std::make_shared<ObserverList>(*slot) : std::make_shared<ObserverList>() };
+
+        const auto handle{ next_handle_++ };
+        observers->push_back(std::make_shared<Observer>(handle, std::move(callback)));
+        slot = std::move(observers);
+
         return handle;
     }
 
-    Handle prependListener(const Type event, const Callback& callback)
+    template <packet::PacketId Id, typename Handler>
+    Handle observe(const Direction direction, Handler&& handler)
+    {
+        return appendObserver(
+            packet_event_type(Id),
+            [direction, handler = std::forward<Handler>(handler)](const ObservedPacket& observed) {
+                if (observed.direction == direction) {
+                    handler(observed);
+                }
+            }
+        );
+    }
+
+    template <typename Handler>
+    Handle observe_raw_packet(const Direction direction, Handler&& handler)
+    {
+        return appendObserver(raw_packet_type(direction), std::forward<Handler>(handler));
+    }
+
+    bool removeListener(const Type event, const Handle handle)
+    {
+        const auto index{ slot_index(event) };
+        if (index == INVALID_SLOT) {
+            return false;
+        }
+
+        if (remove_observer(index, handle)) {
+            return true;
+        }
+
+        if (!slots_[index]) {
+            return false;
+        }
+
+        auto& slot{ slots_[index] };
+        const auto it{ std::ranges::find_if(*slot, [handle](const auto& listener) {
+            return listener->handle == handle;
+        }) };
+        if (it == slot->end()) {
+            return false;
+        }
+
+        // A dispatch in progress still holds the old list, the flag keeps it from calling this listener
+        (*it)->removed = true;
+        profiler_.untrack((*it)->stats.get());
+
+        auto listeners{ std::make_shared<ListenerList>() };
+        listeners->reserve(slot->size() - 1);
+        std::ranges::copy_if(*slot, std::back_inserter(*listeners), [handle](const auto& listener) {
+            return listener->handle != handle;
+        });
+
+        slot = std::move(listeners);
+        return true;
+    }
+
+    [[nodiscard]] bool has_listeners(const Type event) const
+    {
+        const auto index{ slot_index(event) };
+        return index != INVALID_SLOT && slots_[index] && !slots_[index]->empty();
+    }
+
+    [[nodiscard]] bool has_observers(const Type event) const
     {
-        return appendListener(event, callback, Priority::Highest);
+        const auto index{ slot_index(event) };
+        return index != INVALID_SLOT && observer_slots_[index] && !observer_slots_[index]->empty();
     }
 
-    bool removeListener(Type event, const Handle& handle)
+    // Queues a forwarded packet for the observers of its type. Deliveries are batched until
+    // flush_observers(), which the owner calls once its forwarding work is done.
+    void defer(ObservedPacket observed)
     {
-        if (const auto it = handles_.find(event); it != handles_.end()) {
-            auto& entries = it->second;
-            std::erase_if(entries, [&handle](const PriorityEntry& e) { return e.handle == handle; });
+        const auto index{ slot_index(observed.type) };
+        if (index == INVALID_SLOT || !observer_slots_[index] || observer_slots_[index]->empty()) {
+            return;
         }
 
-        return dispatcher_.removeListener(event, handle);
+        pending_.push_back({ std::move(observed), observer_slots_[index] });
     }
 
-    void dispatch(Type event, const Event& e) const
+    void flush_observers()
     {
-        dispatcher_.dispatch(event, e);
+        if (pending_.empty() || !executor_) {
+            return;
+        }
+
+        executor_->post([deliveries = std::move(pending_)] {
+            for (const auto& [observed, observers] : deliveries) {
+                for (const auto& observer : *observers) {
+                    if (observer->removed.load(std::memory_order_acquire)) {
+                        continue;
+                    }
+
+                    try {
+                        observer->callback(observed);
+                    }
+                    catch (const std::exception& e) {
+                        spdlog::error("Observer of event {} threw: {}", static_cast<uint32_t>(observed.type), e.what());
+                    }
+                }
+            }
+        });
+
+        pending_ = {};
+    }
+
+    void dispatch(const Type event, const Event& e) const
+    {
+        const auto index{ slot_index(event) };
+        if (index == INVALID_SLOT) {
+            return;
+        }
+
+        // Listeners may subscribe or unsubscribe from their callback, those only swap the slot's list
+        // while this dispatch keeps iterating the snapshot it started with
+        const auto listeners{ slots_[index] };
+        if (!listeners) {
+            return;
+        }
+
+        const bool profiling{ profiler_.enabled() };
+        for (const auto& listener : *listeners) {
+            if (listener->removed) {
+                continue;
+            }
+
+            if (profiling) {
+                DispatchProfiler::invoke(*listener->stats, e, [&] { listener->callback(e); });
+            }
+            else {
+                listener->callback(e);
+            }
+
+            if (e.canceled) {
+                return;
+            }
+        }
     }
 
     void dispatch(const Event& e) const
     {
-        dispatcher_.dispatch(e);
+        dispatch(e.type, e);
     }
 
-    BaseDispatcher& base() { return dispatcher_; }
-    const BaseDispatcher& base() const { return dispatcher_; }
+    DispatchProfiler& profiler() { return profiler_; }
+    const DispatchProfiler& profiler() const { return profiler_; }
 
 private:
-    struct PriorityEntry {
+    struct Listener {
+        Handle handle;
         int8_t priority;
+        Callback callback;
+        std::shared_ptr<ListenerStats> stats;
+        bool removed;
+
+        Listener(const Handle h, const int8_t p, Callback cb, std::shared_ptr<ListenerStats> s)
+            : handle{ h }
+            , priority{ p }
+            , callback{ std::move(cb) }
+            , stats{ std::move(s) }
+            , removed{ false }
+        { }
+    };
+
+    using ListenerList = std::vector<std::shared_ptr<Listener>>;
+
+    // Observers run on the executor thread, so they are not profiled and the flag is atomic
+    struct Observer {
         Handle handle;
+        ObserverCallback callback;
+        std::atomic<bool> removed;
+
+        Observer(const Handle h, ObserverCallback cb)
+            : handle{ h }
+            , callback{ std::move(cb) }
+            , removed{ false }
+        { }
+    };
+
+    using ObserverList = std::vector<std::shared_ptr<Observer>>;
+
+    struct Delivery {
+        ObservedPacket observed;
+        std::shared_ptr<const ObserverList> observers;
     };
 
-    BaseDispatcher dispatcher_;
-    std::map<Type, std::vector<PriorityEntry>> handles_;
+    bool remove_observer(const std::size_t index, const Handle handle)
+    {
+        auto& slot{ observer_slots_[index] };
+        if (!slot) {
+            return false;
+        }
+
+        const auto it{ std::ranges::find_if(*slot, [handle](const auto& observer) {
+            return observer->handle == handle;
+        }) };
+        if (it == slot->end()) {
+            return false;
+        }
+
+        // Queued deliveries hold the old list, the flag keeps them from calling this observer
+        (*it)->removed.store(true, std::memory_order_release);
+
+        auto observers{ std::make_shared<ObserverList>() };
+        observers->reserve(slot->size() - 1);
+        std::ranges::copy_if(*slot, std::back_inserter(*observers), [handle](const auto& observer) {
+            return observer->handle != handle;
+        });
+        slot = std::move(observers);
+
+        // The observer may be in the middle of a call, its owner is free to go once this returns
+        executor_->wait_idle();
+        return true;
+    }
+
+    // Connection and raw packet types come first, packet event types follow in dense PacketId order
+    static constexpr std::size_t BASIC_TYPE_COUNT{ static_cast<std::size_t>(Type::ServerBoundPacket) + 1 };
+    static constexpr std::size_t SLOT_COUNT{ BASIC_TYPE_COUNT + packet::DENSE_PACKET_ID_COUNT };
+    static constexpr std::size_t INVALID_SLOT{ SLOT_COUNT };
+
+    [[nodiscard]] static constexpr std::size_t slot_index(const Type event)
+    {
+        if (!is_packet_event(event)) {
+            const auto value{ static_cast<std::size_t>(event) };
+            return value < BASIC_TYPE_COUNT ? value : INVALID_SLOT;
+        }
+
+        const auto dense{ packet::dense_index(packet_id_from_type(event)) };
+        return dense != packet::INVALID_DENSE_INDEX ? BASIC_TYPE_COUNT + dense : INVALID_SLOT;
+    }
+
+    std::array<std::shared_ptr<const ListenerList>, SLOT_COUNT> slots_{};
+    Handle next_handle_{ 1 };
+    DispatchProfiler profiler_;
+
+    std::array<std::shared_ptr<const ObserverList>, SLOT_COUNT> observer_slots_{};
+    std::vector<Delivery> pending_;
+    // Started by the first observer, joined first on destruction
+    std::unique_ptr<utils::SerialExecutor> executor_;
 };
 
 using Dispatcher = PriorityEventDispatcher;
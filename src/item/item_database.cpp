@@ -3,6 +3,8 @@
 #include <spdlog/spdlog.h>
 #include <fstream>
 
+#include "../utils/hash.hpp"
+
 namespace item {
 namespace {
 const std::string_view DECRYPT_KEY = "PBG892FXX982ABC*";
@@ -21,7 +23,7 @@ std::string ItemDatabase::decrypt_item_name(std::string_view encrypted, std::uin
     return decrypted;
 }
 
-std::optional<ItemInfo> ItemDatabase::parse_item(utils::ByteStream<>& bs) const
+std::optional<ItemInfo> ItemDatabase::parse_item(utils::ByteStream<>& bs, const std::uint16_t version)
 {
     ItemInfo item{};
 
@@ -122,7 +124,7 @@ std::optional<ItemInfo> ItemDatabase::parse_item(utils::ByteStream<>& bs) const
 
     bs.read(item.ingredients);
 
-    if (version_ >= 24) {
+    if (version >= 24) {
         bs.read(item.__unk_9);
     }
 
@@ -151,26 +153,34 @@ bool ItemDatabase::load_from_file(const std::string& file_path)
 
 bool ItemDatabase::parse(std::span<const std::byte> data)
 {
-    clear();
+    const auto hash{ utils::hash::proton(reinterpret_cast<const char*>(data.data()), data.size()) };
+    if (is_current(hash)) {
+        spdlog::debug("items.dat (hash {}) already loaded, ignoring", hash);
+        return true;
+    }
 
     utils::ByteStream<> bs{ data };
 
-    if (!bs.read(version_) || !bs.read(count_)) {
+    auto snapshot{ std::make_shared<Snapshot>() };
+    snapshot->hash = hash;
+
+    std::uint32_t count{ 0 };
+    if (!bs.read(snapshot->version) || !bs.read(count)) {
         spdlog::error("Failed to read items.dat header");
         return false;
     }
 
-    spdlog::info("Parsing items.dat: version={}, count={}", version_, count_);
+    spdlog::info("Parsing items.dat: version={}, count={}", snapshot->version, count);
 
-    if (version_ > 24) {
-        spdlog::warn("Unsupported items.dat version: {}, max supported is 24", version_);
+    if (snapshot->version > 24) {
+        spdlog::warn("Unsupported items.dat version: {}, max supported is 24", snapshot->version);
         // Don't fail, just warn - parsing might still work for newer versions
     }
 
-    items_.reserve(count_);
+    snapshot->items.reserve(count);
 
-    for (std::uint32_t i = 0; i < count_; ++i) {
-        auto item_result{ parse_item(bs) };
+    for (std::uint32_t i = 0; i < count; ++i) {
+        auto item_result{ parse_item(bs, snapshot->version) };
         if (!item_result.has_value()) {
             spdlog::error("Failed to parse item at index {}", i);
             return false;
@@ -181,26 +191,42 @@ bool ItemDatabase::parse(std::span<const std::byte> data)
             spdlog::warn("Item ID mismatch at index {}: expected {}, got {}", i, i, item.item_id);
         }
 
-        items_.push_back(std::move(item));
+        snapshot->items.push_back(std::move(item));
     }
 
-    spdlog::info("Successfully parsed {} items from items.dat", items_.size());
+    const auto parsed{ snapshot->items.size() };
+    snapshot_.store(std::move(snapshot), std::memory_order_release);
+
+    spdlog::info("Successfully parsed {} items from items.dat", parsed);
     return true;
 }
 
-const ItemInfo* ItemDatabase::get_item(std::uint32_t id) const
+bool ItemDatabase::is_current(const std::uint32_t hash) const noexcept
+{
+    const auto current{ snapshot() };
+    return current && current->hash == hash;
+}
+
+std::shared_ptr<const ItemInfo> ItemDatabase::get_item(const std::uint32_t id) const
 {
-    if (id >= items_.size()) {
+    auto current{ snapshot() };
+    const auto* item{ current ? current->get_item(id) : nullptr };
+    if (!item) {
         return nullptr;
     }
 
-    return &items_[id];
+    return { std::move(current), item };
+}
+
+std::uint16_t ItemDatabase::get_version() const noexcept
+{
+    const auto current{ snapshot() };
+    return current ? current->version : 0;
 }
 
-void ItemDatabase::clear()
+std::uint32_t ItemDatabase::get_count() const noexcept
 {
-    version_ = 0;
-    count_ = 0;
-    items_.clear();
+    const auto current{ snapshot() };
+    return current ? static_cast<std::uint32_t>(current->items.size()) : 0;
 }
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
@@ -9,27 +11,49 @@
 #include "../utils/singleton.hpp"
 
 namespace item {
+// Shared by every shard. Each items.dat is parsed into its own snapshot and published in one atomic
+// store, so readers never lock and a newer items.dat replaces the old one while sessions keep using
+// whatever snapshot they already hold.
 class ItemDatabase : public utils::Singleton<ItemDatabase> {
 public:
+    // One parsed items.dat, never modified once published
+    struct Snapshot {
+        std::uint16_t version;
+        // Proton hash of the items.dat, what the server sends in OnSuperMainStartAcceptLogon
+        std::uint32_t hash;
+        std::vector<ItemInfo> items;
+
+        [[nodiscard]] const ItemInfo* get_item(const std::uint32_t id) const
+        {
+            return id < items.size() ? &items[id] : nullptr;
+        }
+    };
+
     [[nodiscard]] bool load_from_file(const std::string& file_path);
 
     [[nodiscard]] bool parse(std::span<const std::byte> data);
 
-    [[nodiscard]] const ItemInfo* get_item(std::uint32_t id) const;
-    [[nodiscard]] std::uint16_t get_version() const noexcept { return version_; }
-    [[nodiscard]] std::uint32_t get_count() const noexcept { return count_; }
-    [[nodiscard]] bool empty() const noexcept { return items_.empty(); }
+    [[nodiscard]] std::shared_ptr<const Snapshot> snapshot() const noexcept
+    {
+        return snapshot_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool is_loaded() const noexcept { return snapshot() != nullptr; }
+    // Whether the current snapshot was parsed from an items.dat with this hash
+    [[nodiscard]] bool is_current(std::uint32_t hash) const noexcept;
 
-    void clear();
+    // Keeps the snapshot it came from alive
+    [[nodiscard]] std::shared_ptr<const ItemInfo> get_item(std::uint32_t id) const;
+    [[nodiscard]] std::uint16_t get_version() const noexcept;
+    [[nodiscard]] std::uint32_t get_count() const noexcept;
+    [[nodiscard]] bool empty() const noexcept { return get_count() == 0; }
 
 private:
     [[nodiscard]] static std::string decrypt_item_name(std::string_view encrypted, std::uint32_t item_id);
 
-    [[nodiscard]] std::optional<ItemInfo> parse_item(utils::ByteStream<>& bs) const;
+    [[nodiscard]] static std::optional<ItemInfo> parse_item(utils::ByteStream<>& bs, std::uint16_t version);
 
 private:
-    std::uint16_t version_{ 0 };
-    std::uint32_t count_{ 0 };
-    std::vector<ItemInfo> items_;
+    std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
 };
 }
@@ -3,21 +3,31 @@
 #include <stdexcept>
 #include <spdlog/spdlog.h>
 
-#include "../packet/packet_event_registry.hpp"
+#include "packet_dispatch.hpp"
+#include "session.hpp"
+#include "traffic_metrics.hpp"
 #include "../utils/network.hpp"
 
 namespace network {
-Client::Client(core::Config& config, event::Dispatcher& dispatcher)
+Client::Client(core::Config& config, event::Dispatcher& dispatcher, Session& session)
     : ENetWrapper{ create_host() }
     , config_{ config }
     , dispatcher_{ dispatcher }
+    , session_{ session }
     , peer_{ nullptr }
 {
     if (!host_) {
         throw std::runtime_error{ "Failed to create proxy client host" };
     }
+}
 
-    spdlog::info("Proxy client ready to connect");
+Client::~Client()
+{
+    auto& metrics{ TrafficMetrics::instance().outbound(event::Direction::ServerBound) };
+    while (const auto injected{ injected_.pop() }) {
+        enet_packet_destroy(injected->packet);
+        metrics.on_drop();
+    }
 }
 
 ENetHost* Client::create_host()
@@ -55,54 +65,33 @@ bool Client::connect(const std::string& host, std::uint16_t port)
 void Client::on_connect(ENetPeer* peer)
 {
     spdlog::info(
-        "Proxy client connected to Growtopia server at {}:{}",
+        "Session {} connected to Growtopia server at {}:{}",
+        session_.id(),
         utils::network::format_ip_address(peer->address.host),
         peer->address.port
     );
 
     peer_ = peer;
 
-    const event::ConnectionEvent evt{ event::Type::ServerConnect };
+    const event::ConnectionEvent evt{ event::Type::ServerConnect, &session_ };
     dispatcher_.dispatch(evt);
 }
 
-void Client::on_receive(ENetPeer* peer, const std::span<const std::byte> data)
+void Client::on_receive(ENetPeer* peer, ENetPacket* packet, const enet_uint8 channel)
 {
+    ReceivedPacket received{ packet, channel };
     if (peer != peer_) {
         return;
     }
 
+    const auto data{ received.data() };
     if (data.size() < 4) {
         spdlog::warn("Received malformed packet from Growtopia server (size {})", data.size());
         disconnect();
         return;
     }
 
-    const auto decoded{ packet::PacketDecoder::decode(data, config_.get_log_config(), "ClientBound") };
-    if (!decoded.has_value()) {
-        const event::RawPacketEvent evt{ event::Type::ClientBoundPacket, data };
-        dispatcher_.dispatch(evt);
-        return;
-    }
-
-    const auto& packet{ decoded.value() };
-    if (
-        const auto& registry{ packet::event_registry::PacketEventRegistry::instance() };
-        registry.has_event(packet->id())
-    ) {
-        const auto evt{ registry.emit(
-            dispatcher_,
-            event::Direction::ClientBound,
-            packet
-        ) };
-
-        if (evt && evt->canceled) {
-            return;
-        }
-    }
-
-    const event::RawPacketEvent evt{ event::Type::ClientBoundPacket, data };
-    dispatcher_.dispatch(evt);
+    dispatch_received(dispatcher_, config_.get_log_config(), event::Direction::ClientBound, session_, received);
 }
 
 void Client::on_disconnect(ENetPeer* peer)
@@ -113,33 +102,72 @@ void Client::on_disconnect(ENetPeer* peer)
 
     peer_ = nullptr;
 
-    const event::ConnectionEvent evt{ event::Type::ServerDisconnect };
+    const event::ConnectionEvent evt{ event::Type::ServerDisconnect, &session_ };
     dispatcher_.dispatch(evt);
 }
 
-bool Client::write(std::span<const std::byte> data, const int channel) const
+bool Client::write(std::span<const std::byte> data, const int channel, const std::uint32_t flags) const
 {
     if (!is_connected()) {
         return false;
     }
 
+    ENetPacket* packet{ enet_packet_create(data.data(), data.size(), flags) };
+
+    if (enet_peer_send(peer_, channel, packet) != 0) {
+        enet_packet_destroy(packet);
+        return false;
+    }
+
+    return true;
+}
+
+bool Client::write(const std::vector<std::byte>& data, const int channel, const std::uint32_t flags) const
+{
+    return write(std::span{ data.data(), data.size() }, channel, flags);
+}
+
+bool Client::forward(ReceivedPacket& packet, const int channel)
+{
+    if (!is_connected()) {
+        return false;
+    }
+
+    // Same thread as the packet owner, ENet just takes another reference
+    return enet_peer_send(peer_, channel, packet.get()) == 0;
+}
+
+bool Client::inject(std::span<const std::byte> data, const int channel)
+{
+    // Copied on the calling thread, the shard only links the packet into the peer's queue
     ENetPacket* packet{ enet_packet_create(
         data.data(),
         data.size(),
         ENET_PACKET_FLAG_RELIABLE
     ) };
 
-    if (enet_peer_send(peer_, channel, packet) != 0) {
-        enet_packet_destroy(packet);
+    if (!packet) {
         return false;
     }
 
+    injected_.push({ packet, channel, std::chrono::steady_clock::now() });
+    TrafficMetrics::instance().outbound(event::Direction::ServerBound).on_enqueue();
     return true;
 }
 
-bool Client::write(const std::vector<std::byte>& data, const int channel) const
+void Client::drain_injected()
 {
-    return write(std::span{ data.data(), data.size() }, channel);
+    auto& metrics{ TrafficMetrics::instance().outbound(event::Direction::ServerBound) };
+    while (const auto injected{ injected_.pop() }) {
+        const auto& [packet, channel, enqueued_at]{ *injected };
+        if (!is_connected() || enet_peer_send(peer_, static_cast<enet_uint8>(channel), packet) != 0) {
+            enet_packet_destroy(packet);
+            metrics.on_drop();
+            continue;
+        }
+
+        metrics.on_send(enqueued_at);
+    }
 }
 
 void Client::disconnect() const
@@ -164,10 +192,21 @@ bool Client::is_connected() const
     return peer_ && peer_->state == ENET_PEER_STATE_CONNECTED;
 }
 
-void Client::flush() const
+bool Client::is_active() const
+{
+    // A peer that never finished connecting is reset without a disconnect event
+    return peer_ && peer_->state != ENET_PEER_STATE_DISCONNECTED;
+}
+
+void Client::flush()
 {
-    if (host_) {
-        enet_host_flush(host_);
+    drain_injected();
+
+    if (!host_) {
+        return;
     }
+
+    enet_host_flush(host_);
+    TrafficMetrics::instance().datagrams(event::Direction::ServerBound).collect(*host_);
 }
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <span>
 #include <string>
 #include <enet/enet.h>
@@ -8,36 +9,66 @@
 #include "../core/config.hpp"
 #include "../event/event.hpp"
 #include "../packet/packet_decoder.hpp"
+#include "../utils/mpsc_queue.hpp"
 
 namespace network {
+class Session;
+
 class Client final : public ENetWrapper, public IConnection {
 public:
-    Client(core::Config& config, event::Dispatcher& dispatcher);
+    Client(core::Config& config, event::Dispatcher& dispatcher, Session& session);
+    ~Client() override;
 
     bool connect(const std::string& host, std::uint16_t port);
 
-    [[nodiscard]] bool write(std::span<const std::byte> data, int channel = 0) const override;
-    [[nodiscard]] bool write(const std::vector<std::byte>& data, int channel = 0) const override;
+    [[nodiscard]] bool write(
+        std::span<const std::byte> data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const override;
+    [[nodiscard]] bool write(
+        const std::vector<std::byte>& data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const override;
+    bool forward(ReceivedPacket& packet, int channel = 0) override;
+
+    // Thread-safe and lock-free, the packet is sent by the owning shard during its next flush().
+    // Packets injected from one thread keep their order. Whoever injects has to wake the shard.
+    bool inject(std::span<const std::byte> data, int channel = 0);
 
     void disconnect() const;
     void disconnect_now();
 
     [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] bool is_active() const;
 
-    void flush() const;
+    // Sends the injected packets, then everything ENet has queued
+    void flush();
 
 protected:
     void on_connect(ENetPeer* peer) override;
-    void on_receive(ENetPeer* peer, std::span<const std::byte> data) override;
+    void on_receive(ENetPeer* peer, ENetPacket* packet, enet_uint8 channel) override;
     void on_disconnect(ENetPeer* peer) override;
 
 private:
+    struct Injected {
+        ENetPacket* packet;
+        int channel;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+
     static ENetHost* create_host();
 
+    void drain_injected();
+
 private:
     core::Config& config_;
 
     event::Dispatcher& dispatcher_;
+    Session& session_;
     ENetPeer* peer_;
+
+    utils::MpscQueue<Injected> injected_;
 };
 }
@@ -1,7 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <span>
 #include <vector>
 
+#include "received_packet.hpp"
 #include "../packet/packet_helper.hpp"
 
 namespace network {
@@ -9,8 +11,23 @@ class IConnection {
 public:
     virtual ~IConnection() = default;
 
-    [[nodiscard]] virtual bool write(std::span<const std::byte> data, int channel = 0) const = 0;
-    [[nodiscard]] virtual bool write(const std::vector<std::byte>& data, int channel = 0) const = 0;
+    [[nodiscard]] virtual bool write(
+        std::span<const std::byte> data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const = 0;
+    [[nodiscard]] virtual bool write(
+        const std::vector<std::byte>& data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const = 0;
+
+    // Sends a packet received from the other side unmodified, with the delivery flags it arrived
+    // with. Connections that can share the ENet packet override this to skip the copy.
+    virtual bool forward(ReceivedPacket& packet, const int channel = 0)
+    {
+        return write(packet.data(), channel, packet.flags());
+    }
 
     template <class Packet>
     bool write(Packet& packet) {
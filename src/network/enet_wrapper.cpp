@@ -23,23 +23,16 @@ void ENetWrapper::process()
         return;
     }
 
+    // Never block here, core::EventLoop is responsible for waiting on the socket
     ENetEvent event{};
-    while (enet_host_service(host_, &event, 1) > 0) {
+    while (enet_host_service(host_, &event, 0) > 0) {
         switch (event.type) {
         case ENET_EVENT_TYPE_CONNECT:
             on_connect(event.peer);
             break;
-        case ENET_EVENT_TYPE_RECEIVE: {
-            on_receive(
-                event.peer,
-                std::span{
-                    reinterpret_cast<std::byte*>(event.packet->data),
-                    event.packet->dataLength
-                }
-            );
-            enet_packet_destroy(event.packet);
+        case ENET_EVENT_TYPE_RECEIVE:
+            on_receive(event.peer, event.packet, event.channelID);
             break;
-        }
         case ENET_EVENT_TYPE_DISCONNECT:
             on_disconnect(event.peer);
             break;
@@ -1,6 +1,4 @@
 #pragma once
-#include <cstddef>
-#include <span>
 #include <enet/enet.h>
 
 #include "../utils/types.hpp"
@@ -13,12 +11,14 @@ public:
     void process();
 
     [[nodiscard]] bool is_valid() const { return host_ != nullptr; }
+    [[nodiscard]] ENetSocket socket() const { return host_ ? host_->socket : ENET_SOCKET_NULL; }
 
 protected:
     explicit ENetWrapper(ENetHost* host);
 
     virtual void on_connect(ENetPeer* peer) = 0;
-    virtual void on_receive(ENetPeer* peer, std::span<const std::byte> data) = 0;
+    // Takes ownership of the packet, see network::ReceivedPacket.
+    virtual void on_receive(ENetPeer* peer, ENetPacket* packet, enet_uint8 channel) = 0;
     virtual void on_disconnect(ENetPeer* peer) = 0;
 
 protected:
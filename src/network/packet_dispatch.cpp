@@ -0,0 +1,75 @@
+#include "packet_dispatch.hpp"
+
+#include "received_packet.hpp"
+#include "session.hpp"
+#include "../packet/packet_decoder.hpp"
+#include "../packet/packet_event_registry.hpp"
+
+namespace network {
+namespace {
+void dispatch_raw(
+    event::Dispatcher& dispatcher,
+    const event::Direction direction,
+    Session& session,
+    ReceivedPacket& received,
+    const std::shared_ptr<packet::IPacket>& decoded = nullptr
+) {
+    const auto data{ received.data() };
+    const event::RawPacketEvent evt{
+        event::raw_packet_type(direction),
+        data,
+        &session,
+        &received,
+        received.channel(),
+        received.flags()
+    };
+    dispatcher.dispatch(evt);
+
+    if (!evt.canceled) {
+        packet::event_registry::PacketEventRegistry::instance().observe(dispatcher, direction, session.id(), data, decoded);
+    }
+}
+}
+
+void dispatch_received(
+    event::Dispatcher& dispatcher,
+    const core::Config::LogConfig& log_config,
+    const event::Direction direction,
+    Session& session,
+    ReceivedPacket& received
+) {
+    // Decode only what a listener or the log config is going to look at, everything else is forwarded raw
+    const auto& registry{ packet::event_registry::PacketEventRegistry::instance() };
+    const auto classification{ packet::PacketDecoder::classify(received.data()) };
+    if (
+        !classification
+        || (
+            !registry.is_observed(dispatcher, classification->id)
+            && !packet::PacketDecoder::is_logged(*classification, log_config)
+        )
+    ) {
+        dispatch_raw(dispatcher, direction, session, received);
+        return;
+    }
+
+    const auto decoded{ packet::PacketDecoder::decode(
+        received.share(),
+        log_config,
+        direction == event::Direction::ClientBound ? "ClientBound" : "ServerBound"
+    ) };
+    if (!decoded.has_value()) {
+        dispatch_raw(dispatcher, direction, session, received);
+        return;
+    }
+
+    const auto& decoded_packet{ decoded.value() };
+    if (registry.has_event(decoded_packet->id())) {
+        const auto evt{ registry.emit(dispatcher, direction, decoded_packet, &session) };
+        if (evt && evt->canceled) {
+            return;
+        }
+    }
+
+    dispatch_raw(dispatcher, direction, session, received, decoded_packet);
+}
+}
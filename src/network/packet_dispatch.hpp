@@ -0,0 +1,20 @@
+#pragma once
+#include "../core/config.hpp"
+#include "../event/event.hpp"
+
+namespace network {
+class ReceivedPacket;
+class Session;
+
+// Runs a packet received from either side through the dispatcher. The typed event goes first and
+// the packet is only decoded when a listener, an observer or the log config wants it. Unless a
+// typed listener cancels, the raw event follows and forwards the packet, observers get their copies
+// once nothing canceled that either.
+void dispatch_received(
+    event::Dispatcher& dispatcher,
+    const core::Config::LogConfig& log_config,
+    event::Direction direction,
+    Session& session,
+    ReceivedPacket& received
+);
+}
@@ -0,0 +1,91 @@
+#include "peer_connection.hpp"
+
+#include "received_packet.hpp"
+#include "server.hpp"
+
+namespace network {
+PeerConnection::PeerConnection(Server& server, ENetPeer* peer)
+    : server_{ server }
+    , peer_{ peer }
+    , connect_id_{ peer->connectID }
+    , connected_{ true }
+    , active_{ true }
+{
+
+}
+
+bool PeerConnection::write(std::span<const std::byte> data, const int channel, const std::uint32_t flags) const
+{
+    if (!is_connected()) {
+        return false;
+    }
+
+    ENetPacket* packet{ enet_packet_create(data.data(), data.size(), flags) };
+
+    if (!packet) {
+        return false;
+    }
+
+    // A listener after the forwarding one must not overtake the packet being forwarded
+    if (!ReceivedPacket::hold(*this, packet, channel)) {
+        send(packet, channel, true);
+    }
+
+    return true;
+}
+
+bool PeerConnection::write(const std::vector<std::byte>& data, const int channel, const std::uint32_t flags) const
+{
+    return write(std::span{ data.data(), data.size() }, channel, flags);
+}
+
+bool PeerConnection::forward(ReceivedPacket& packet, const int channel)
+{
+    if (!is_connected()) {
+        return false;
+    }
+
+    packet.hand_off(*this, channel);
+    return true;
+}
+
+void PeerConnection::send(ENetPacket* packet, const int channel, const bool coalesce) const
+{
+    if (!is_connected()) {
+        enet_packet_destroy(packet);
+        return;
+    }
+
+    server_.send(peer_, connect_id_, channel, packet, coalesce);
+}
+
+void PeerConnection::disconnect() const
+{
+    if (!connected_.exchange(false)) {
+        return;
+    }
+
+    server_.disconnect(peer_, connect_id_, false);
+}
+
+void PeerConnection::disconnect_now()
+{
+    if (!active_.exchange(false)) {
+        return;
+    }
+
+    connected_ = false;
+    server_.disconnect(peer_, connect_id_, true);
+}
+
+bool PeerConnection::is_connected() const
+{
+    return connected_.load(std::memory_order_acquire);
+}
+
+void PeerConnection::release()
+{
+    connected_ = false;
+    active_ = false;
+}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <enet/enet.h>
+
+#include "connection.hpp"
+
+namespace network {
+class Server;
+
+// Downstream side of a session, the Growtopia client peer accepted by network::Server. The peer
+// belongs to the acceptor thread, so writes and disconnects are handed to it instead of ENet.
+class PeerConnection final : public IConnection {
+public:
+    PeerConnection(Server& server, ENetPeer* peer);
+
+    [[nodiscard]] bool write(
+        std::span<const std::byte> data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const override;
+    [[nodiscard]] bool write(
+        const std::vector<std::byte>& data,
+        int channel = 0,
+        std::uint32_t flags = ENET_PACKET_FLAG_RELIABLE
+    ) const override;
+    bool forward(ReceivedPacket& packet, int channel = 0) override;
+
+    // Takes ownership of the packet. Forwarded packets are never held back for coalescing, packets
+    // the proxy builds itself go through write() and may be.
+    void send(ENetPacket* packet, int channel, bool coalesce = false) const;
+
+    void disconnect() const;
+    void disconnect_now();
+
+    [[nodiscard]] bool is_connected() const override;
+    [[nodiscard]] bool is_active() const { return active_.load(std::memory_order_acquire); }
+
+    // Called by network::Server once ENet reported the peer as disconnected.
+    void release();
+
+private:
+    Server& server_;
+    ENetPeer* peer_;
+    std::uint32_t connect_id_;
+
+    mutable std::atomic<bool> connected_;
+    std::atomic<bool> active_;
+};
+}
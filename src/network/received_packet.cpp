@@ -0,0 +1,108 @@
+#include "received_packet.hpp"
+
+#include <utility>
+
+#include "peer_connection.hpp"
+#include "traffic_metrics.hpp"
+
+namespace network {
+namespace {
+constexpr std::uint32_t DELIVERY_FLAGS{
+    ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_UNSEQUENCED | ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT
+};
+
+// Packet whose hand-off is pending on this thread, writes from other threads are never held
+thread_local ReceivedPacket* pending_hand_off{ nullptr };
+}
+
+ReceivedPacket::ReceivedPacket(ENetPacket* packet, const int channel)
+    : packet_{ packet }
+    , channel_{ channel }
+    , flags_{ packet->flags & DELIVERY_FLAGS }
+    , hand_off_to_{ nullptr }
+    , hand_off_channel_{ 0 }
+    , previous_pending_{ nullptr }
+{
+
+}
+
+ReceivedPacket::~ReceivedPacket()
+{
+    if (!packet_) {
+        return;
+    }
+
+    if (hand_off_to_) {
+        if (pending_hand_off == this) {
+            pending_hand_off = previous_pending_;
+        }
+
+        // ENet reference counts are not atomic, the packet may only cross threads while nothing
+        // else holds it. Otherwise the other thread gets its own copy.
+        const bool handed_over{ packet_->referenceCount == 0 };
+        TrafficMetrics::instance().forwards().on_hand_off(!handed_over);
+        if (handed_over) {
+            hand_off_to_->send(packet_, hand_off_channel_);
+        }
+        else {
+            send_copy(*hand_off_to_, hand_off_channel_);
+        }
+
+        for (const auto& [packet, channel] : held_) {
+            hand_off_to_->send(packet, channel, true);
+        }
+
+        if (handed_over) {
+            return;
+        }
+    }
+
+    if (packet_->referenceCount == 0) {
+        enet_packet_destroy(packet_);
+    }
+}
+
+utils::SharedBytes ReceivedPacket::share() const
+{
+    ++packet_->referenceCount;
+
+    return {
+        std::shared_ptr<const void>{ packet_, [](ENetPacket* packet) {
+            if (--packet->referenceCount == 0) {
+                enet_packet_destroy(packet);
+            }
+        } },
+        data()
+    };
+}
+
+void ReceivedPacket::send_copy(const PeerConnection& connection, const int channel) const
+{
+    if (ENetPacket* copy{ enet_packet_create(packet_->data, packet_->dataLength, flags_) }) {
+        connection.send(copy, channel);
+    }
+}
+
+void ReceivedPacket::hand_off(PeerConnection& connection, const int channel)
+{
+    if (hand_off_to_) {
+        // Already claimed by another connection, fall back to a copy for this one
+        send_copy(connection, channel);
+        return;
+    }
+
+    hand_off_to_ = &connection;
+    hand_off_channel_ = channel;
+    previous_pending_ = std::exchange(pending_hand_off, this);
+}
+
+bool ReceivedPacket::hold(const PeerConnection& connection, ENetPacket* packet, const int channel)
+{
+    if (!pending_hand_off || pending_hand_off->hand_off_to_ != &connection) {
+        return false;
+    }
+
+    pending_hand_off->held_.push_back({ packet, channel });
+    return true;
+}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <enet/enet.h>
+
+#include "../utils/shared_bytes.hpp"
+#include "../utils/types.hpp"
+
+namespace network {
+class PeerConnection;
+
+// Owning handle for a packet ENet handed to us. Sending it to another peer of the same host thread
+// only takes a reference, sending it to a downstream peer owned by the acceptor thread is deferred
+// until the handle goes away so every listener of the current dispatch can still read the data.
+// Writes to that peer from later listeners of the same dispatch are held until then as well, so
+// the peer receives packets in listener order with the forwarded one at its forwarding point.
+class ReceivedPacket final : public utils::types::Immobile {
+public:
+    explicit ReceivedPacket(ENetPacket* packet, int channel = 0);
+    ~ReceivedPacket();
+
+    [[nodiscard]] ENetPacket* get() const { return packet_; }
+    [[nodiscard]] int channel() const { return channel_; }
+    // Delivery flags as received, before sending the packet on adds ENet's bookkeeping flags
+    [[nodiscard]] std::uint32_t flags() const { return flags_; }
+    [[nodiscard]] std::span<const std::byte> data() const
+    {
+        return { reinterpret_cast<const std::byte*>(packet_->data), packet_->dataLength };
+    }
+
+    // Reference to the packet data for decoded payloads, taken through the ENet reference count so
+    // the buffer outlives this handle if a listener keeps the packet. Must be released on the thread
+    // that owns the packet, and a live share turns a cross-thread hand-off into a copy. Those copies
+    // are counted in TrafficMetrics::forwards(), shown by /netstats.
+    [[nodiscard]] utils::SharedBytes share() const;
+
+    void hand_off(PeerConnection& connection, int channel);
+
+    // Takes the packet if a packet being dispatched on this thread was handed off to the connection,
+    // it then goes out right after the hand-off. Returns false when the write is not held.
+    [[nodiscard]] static bool hold(const PeerConnection& connection, ENetPacket* packet, int channel);
+
+private:
+    // Copy for the downstream peer, sent as forwarded traffic
+    void send_copy(const PeerConnection& connection, int channel) const;
+
+private:
+    ENetPacket* packet_;
+    int channel_;
+    std::uint32_t flags_;
+
+    PeerConnection* hand_off_to_;
+    int hand_off_channel_;
+
+    struct HeldWrite {
+        ENetPacket* packet;
+        int channel;
+    };
+
+    std::vector<HeldWrite> held_;
+    ReceivedPacket* previous_pending_;
+};
+}
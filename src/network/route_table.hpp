@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <fmt/format.h>
+
+namespace network {
+struct Route {
+    std::string address;
+    std::uint16_t port;
+    // meta from the real server_data.php response, the client logs in with the proxy's token instead
+    std::string meta;
+};
+
+// Upstream routes waiting for a Growtopia client to (re)connect to the proxy. After server_data.php
+// or OnSendToServer the client comes back as a brand new ENet peer, possibly next to other clients
+// on the same address. Routes are therefore keyed by something the client repeats in its login
+// packet: a meta token the proxy hands out in server_data.php, or the user and token pair of
+// OnSendToServer. Filled from the web server thread as well.
+class RouteTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto Expiry{ std::chrono::seconds{ 30 } };
+
+    [[nodiscard]] static std::string meta_key(const std::string_view meta)
+    {
+        return fmt::format("meta:{}", meta);
+    }
+
+    [[nodiscard]] static std::string transfer_key(const std::string_view user, const std::string_view token)
+    {
+        return fmt::format("transfer:{}:{}", user, token);
+    }
+
+    // Unique enough to tell apart every server_data.php request within the expiry window
+    [[nodiscard]] std::string make_meta_token()
+    {
+        std::scoped_lock lock{ mutex_ };
+        return fmt::format("gtproxy-{:016x}", generator_());
+    }
+
+    void push(std::string key, Route route)
+    {
+        std::scoped_lock lock{ mutex_ };
+
+        const auto now{ Clock::now() };
+        std::erase_if(routes_, [now](const auto& entry) { return entry.second.expires_at < now; });
+
+        routes_.insert_or_assign(std::move(key), PendingRoute{ std::move(route), now + Expiry });
+    }
+
+    [[nodiscard]] std::optional<Route> take(const std::string& key)
+    {
+        std::scoped_lock lock{ mutex_ };
+
+        const auto it{ routes_.find(key) };
+        if (it == routes_.end()) {
+            return std::nullopt;
+        }
+
+        const bool expired{ it->second.expires_at < Clock::now() };
+        Route route{ std::move(it->second.route) };
+        routes_.erase(it);
+
+        if (expired) {
+            return std::nullopt;
+        }
+
+        return route;
+    }
+
+private:
+    struct PendingRoute {
+        Route route;
+        Clock::time_point expires_at;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, PendingRoute> routes_;
+    std::mt19937_64 generator_{ std::random_device{}() };
+};
+}
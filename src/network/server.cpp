@@ -1,37 +1,59 @@
 #include "server.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <spdlog/spdlog.h>
 
-#include "../packet/packet_decoder.hpp"
-#include "../packet/packet_event_registry.hpp"
+#include "traffic_metrics.hpp"
 #include "../utils/network.hpp"
 
 namespace network {
-Server::Server(core::Config& config, event::Dispatcher& dispatcher)
-    : ENetWrapper{ create_host(config.get_server_config().port) }
+Server::Server(core::Config& config, core::EventLoop& event_loop)
+    : ENetWrapper{ create_host(
+        config.get_server_config().port,
+        static_cast<std::size_t>(std::max(config.get_server_config().max_sessions, 1))
+    ) }
     , config_{ config }
-    , dispatcher_{ dispatcher }
-    , peer_{ nullptr }
+    , event_loop_{ event_loop }
+    , next_session_id_{ 1 }
+    , wake_pending_{ false }
+    , coalesce_window_{ std::max(config.get_loop_config().coalesce_window_us, 0) }
 {
     if (!host_) {
         throw std::runtime_error{"Failed to create proxy server host"};
     }
 
+    event_loop_.add_socket(socket());
+
     spdlog::info(
-        "Proxy server listening on port {} (max {} peers)",
+        "Proxy server listening on port {} (max {} sessions)",
         host_->address.port,
         host_->peerCount
     );
 }
 
-ENetHost* Server::create_host(std::uint16_t port)
+Server::~Server()
+{
+    event_loop_.remove_socket(socket());
+
+    while (const auto outbound{ outbound_.pop() }) {
+        if (outbound->packet) {
+            enet_packet_destroy(outbound->packet);
+        }
+    }
+
+    for (const auto& outbound : held_) {
+        enet_packet_destroy(outbound.packet);
+    }
+}
+
+ENetHost* Server::create_host(std::uint16_t port, const std::size_t max_sessions)
 {
     ENetAddress address{};
     address.host = ENET_HOST_ANY;
     address.port = port;
 
-    ENetHost* host{ enet_host_create(&address, 1, 2, 0, 0) };
+    ENetHost* host{ enet_host_create(&address, max_sessions, 2, 0, 0) };
     if (!host) {
         return nullptr;
     }
@@ -47,123 +69,227 @@ ENetHost* Server::create_host(std::uint16_t port)
     return host;
 }
 
-void Server::on_connect(ENetPeer* peer)
+void Server::add_worker(ISessionWorker& worker)
 {
-    spdlog::info(
-        "Client {}:{} connected to proxy server",
-        utils::network::format_ip_address(peer->address.host),
-        peer->address.port
-    );
-
-    enet_peer_timeout(peer, 0, ENET_PEER_TIMEOUT_MAXIMUM / 2, 0);
-    peer_ = peer;
-
-    const event::ConnectionEvent evt{ event::Type::ClientConnect };
-    dispatcher_.dispatch(evt);
+    workers_.push_back(&worker);
 }
 
-void Server::on_receive(ENetPeer* peer, const std::span<const std::byte> data)
+void Server::process()
 {
-    if (peer != peer_) {
-        return;
-    }
+    ENetWrapper::process();
+    drain_outbound();
+}
 
-    if (data.size() < 4 || data.size() > 16384) {
-        spdlog::warn("Received malformed packet from client (size {})", data.size());
-        disconnect();
-        return;
-    }
+void Server::flush()
+{
+    drain_outbound();
 
-    const auto decoded{ packet::PacketDecoder::decode(data, config_.get_log_config(), "ServerBound") };
-    if (!decoded.has_value()) {
-        const event::RawPacketEvent evt{ event::Type::ServerBoundPacket, data };
-        dispatcher_.dispatch(evt);
+    if (!host_) {
         return;
     }
 
-    const auto& packet{ decoded.value() };
-    if (
-        const auto& registry{ packet::event_registry::PacketEventRegistry::instance() };
-        registry.has_event(packet->id())
-    ) {
-        const auto evt{ registry.emit(
-            dispatcher_,
-            event::Direction::ServerBound,
-            packet
-        ) };
+    enet_host_flush(host_);
+    TrafficMetrics::instance().datagrams(event::Direction::ClientBound).collect(*host_);
+}
 
-        if (evt && evt->canceled) {
-            return;
-        }
+std::optional<core::EventLoop::Clock::time_point> Server::next_deadline() const
+{
+    if (held_.empty()) {
+        return std::nullopt;
     }
 
-    const event::RawPacketEvent evt{ event::Type::ServerBoundPacket, data };
-    dispatcher_.dispatch(evt);
+    return held_.front().enqueued_at + coalesce_window_;
 }
 
-void Server::on_disconnect(ENetPeer* peer)
+ISessionWorker* Server::least_loaded_worker() const
 {
-    if (peer != peer_) {
-        return;
-    }
+    const auto it{ std::ranges::min_element(workers_, {}, &ISessionWorker::load) };
+    return it != workers_.end() ? *it : nullptr;
+}
 
-    peer_ = nullptr;
+void Server::send(
+    ENetPeer* peer,
+    const std::uint32_t connect_id,
+    const int channel,
+    ENetPacket* packet,
+    const bool coalesce
+) {
+    outbound_.push({
+        Outbound::Type::Send,
+        peer,
+        connect_id,
+        channel,
+        packet,
+        std::chrono::steady_clock::now(),
+        coalesce && coalesce_window_.count() > 0
+    });
+    TrafficMetrics::instance().outbound(event::Direction::ClientBound).on_enqueue();
 
-    const event::ConnectionEvent evt{ event::Type::ClientDisconnect };
-    dispatcher_.dispatch(evt);
+    wake();
 }
 
-bool Server::write(std::span<const std::byte> data, const int channel) const
+void Server::disconnect(ENetPeer* peer, const std::uint32_t connect_id, const bool now)
 {
-    if (!is_connected()) {
-        return false;
+    outbound_.push({
+        now ? Outbound::Type::DisconnectNow : Outbound::Type::Disconnect,
+        peer,
+        connect_id,
+        0,
+        nullptr,
+        std::chrono::steady_clock::now(),
+        false
+    });
+
+    wake();
+}
+
+void Server::wake()
+{
+    if (!wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        event_loop_.wake();
     }
+}
 
-    ENetPacket* packet{ enet_packet_create(
-        data.data(),
-        data.size(),
-        ENET_PACKET_FLAG_RELIABLE
-    ) };
+void Server::drain_outbound()
+{
+    // Cleared before popping, a push racing this drain wakes the loop again
+    wake_pending_.store(false, std::memory_order_release);
 
-    if (enet_peer_send(peer_, channel, packet) != 0) {
-        enet_packet_destroy(packet);
-        return false;
+    while (const auto outbound{ outbound_.pop() }) {
+        if (outbound->coalesce) {
+            held_.push_back(*outbound);
+            continue;
+        }
+
+        // Held packets were queued first, they have to reach ENet before this one
+        release_held();
+        apply(*outbound);
+    }
+
+    // A push still being linked was skipped by pop(), make sure its producer's wake-up is not lost
+    if (!outbound_.empty()) {
+        wake();
     }
 
-    return true;
+    if (!held_.empty() && core::EventLoop::Clock::now() >= held_.front().enqueued_at + coalesce_window_) {
+        release_held();
+    }
 }
 
-bool Server::write(const std::vector<std::byte>& data, const int channel) const
+void Server::release_held()
 {
-    return write(std::span{ data.data(), data.size() }, channel);
+    for (const auto& outbound : held_) {
+        apply(outbound);
+    }
+
+    held_.clear();
 }
 
-void Server::disconnect() const
+void Server::apply(const Outbound& outbound)
 {
-    if (peer_) {
-        enet_peer_disconnect(peer_, 0);
+    auto& metrics{ TrafficMetrics::instance().outbound(event::Direction::ClientBound) };
+
+    const auto& [type, peer, connect_id, channel, packet, enqueued_at, coalesce]{ outbound };
+    if (peer->connectID != connect_id || peer->state != ENET_PEER_STATE_CONNECTED) {
+        if (packet) {
+            enet_packet_destroy(packet);
+            metrics.on_drop();
+        }
+
+        return;
+    }
+
+    switch (type) {
+    case Outbound::Type::Send:
+        if (enet_peer_send(peer, static_cast<enet_uint8>(channel), packet) != 0) {
+            enet_packet_destroy(packet);
+            metrics.on_drop();
+        }
+        else {
+            metrics.on_send(enqueued_at);
+        }
+        break;
+    case Outbound::Type::Disconnect:
+        enet_peer_disconnect(peer, 0);
+        break;
+    case Outbound::Type::DisconnectNow:
+        // No disconnect event is generated for this, forget the session right away
+        if (const auto* session{ static_cast<Session*>(peer->data) }) {
+            sessions_.erase(session->id());
+        }
+
+        peer->data = nullptr;
+        enet_peer_disconnect_now(peer, 0);
+        break;
     }
 }
 
-void Server::disconnect_now()
+void Server::on_connect(ENetPeer* peer)
 {
-    if (!peer_) {
+    spdlog::info(
+        "Client {}:{} connected to proxy server",
+        utils::network::format_ip_address(peer->address.host),
+        peer->address.port
+    );
+
+    auto* worker{ least_loaded_worker() };
+    if (!worker) {
+        enet_peer_disconnect_now(peer, 0);
         return;
     }
 
-    enet_peer_disconnect_now(peer_, 0);
-    peer_ = nullptr;
+    std::shared_ptr<Session> session;
+    try {
+        session = std::make_shared<Session>(next_session_id_++, peer, *this, config_, *worker);
+    }
+    catch (const std::exception& e) {
+        spdlog::error("Failed to create session: {}", e.what());
+        enet_peer_disconnect_now(peer, 0);
+        return;
+    }
+
+    enet_peer_timeout(peer, 0, ENET_PEER_TIMEOUT_MAXIMUM / 2, 0);
+    peer->data = session.get();
+
+    sessions_.emplace(session->id(), session);
+    worker->post({ SessionMessage::Type::Connect, std::move(session), nullptr });
 }
 
-bool Server::is_connected() const
+void Server::on_receive(ENetPeer* peer, ENetPacket* packet, const enet_uint8 channel)
 {
-    return peer_ && peer_->state == ENET_PEER_STATE_CONNECTED;
+    auto* session{ static_cast<Session*>(peer->data) };
+    if (!session) {
+        enet_packet_destroy(packet);
+        return;
+    }
+
+    if (packet->dataLength < 4 || packet->dataLength > 16384) {
+        spdlog::warn("Received malformed packet from session {} (size {})", session->id(), packet->dataLength);
+        enet_packet_destroy(packet);
+        enet_peer_disconnect(peer, 0);
+        return;
+    }
+
+    // The packet itself moves to the worker, nothing on this thread touches it afterward
+    session->worker().post({ SessionMessage::Type::Receive, session->shared_from_this(), packet, channel });
 }
 
-void Server::flush() const
+void Server::on_disconnect(ENetPeer* peer)
 {
-    if (host_) {
-        enet_host_flush(host_);
+    auto* session{ static_cast<Session*>(peer->data) };
+    if (!session) {
+        return;
     }
+
+    peer->data = nullptr;
+    session->downstream().release();
+
+    const auto it{ sessions_.find(session->id()) };
+    if (it == sessions_.end()) {
+        return;
+    }
+
+    session->worker().post({ SessionMessage::Type::Disconnect, std::move(it->second), nullptr });
+    sessions_.erase(it);
 }
 }
@@ -1,39 +1,97 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <span>
+#include <unordered_map>
+#include <vector>
 #include <enet/enet.h>
 
-#include "connection.hpp"
 #include "enet_wrapper.hpp"
+#include "route_table.hpp"
+#include "session.hpp"
+#include "session_worker.hpp"
 #include "../core/config.hpp"
-#include "../event/event.hpp"
+#include "../core/event_loop.hpp"
+#include "../utils/mpsc_queue.hpp"
 
 namespace network {
-class Server final : public ENetWrapper, public IConnection {
+// Acceptor for the listening host shared by every player. Each accepted peer becomes a
+// network::Session owned by one of the session workers, downstream traffic is relayed between
+// the peer and its worker through queues so the host itself is only touched on this thread.
+class Server final : public ENetWrapper {
 public:
-    Server(core::Config& config, event::Dispatcher& dispatcher);
+    Server(core::Config& config, core::EventLoop& event_loop);
+    ~Server() override;
 
-    [[nodiscard]] bool write(std::span<const std::byte> data, int channel = 0) const override;
-    [[nodiscard]] bool write(const std::vector<std::byte>& data, int channel = 0) const override;
+    void add_worker(ISessionWorker& worker);
 
-    void disconnect() const;
-    void disconnect_now();
+    // Services the listening host, then sends everything the workers queued for their peers.
+    void process();
+    // Hands everything due to ENet and pushes it out, the last stage of a Core::run iteration.
+    void flush();
 
-    [[nodiscard]] bool is_connected() const override;
+    // When the oldest held proxy-originated packet has to go out
+    [[nodiscard]] std::optional<core::EventLoop::Clock::time_point> next_deadline() const;
 
-    void flush() const;
+    [[nodiscard]] RouteTable& routes() { return routes_; }
+
+    // Thread-safe and lock-free, used by PeerConnection. Requests from one thread are applied in the
+    // order they were made. Stale requests for a peer slot that has since been reused are dropped by
+    // comparing ENetPeer::connectID. Coalesced sends are held for the configured window, anything
+    // else releases them first so the order is kept.
+    void send(ENetPeer* peer, std::uint32_t connect_id, int channel, ENetPacket* packet, bool coalesce = false);
+    void disconnect(ENetPeer* peer, std::uint32_t connect_id, bool now);
 
 protected:
     void on_connect(ENetPeer* peer) override;
-    void on_receive(ENetPeer* peer, std::span<const std::byte> data) override;
+    void on_receive(ENetPeer* peer, ENetPacket* packet, enet_uint8 channel) override;
     void on_disconnect(ENetPeer* peer) override;
 
 private:
-    static ENetHost* create_host(std::uint16_t port);
+    struct Outbound {
+        enum class Type {
+            Send,
+            Disconnect,
+            DisconnectNow
+        };
+
+        Type type;
+        ENetPeer* peer;
+        std::uint32_t connect_id;
+        int channel;
+        ENetPacket* packet;
+        std::chrono::steady_clock::time_point enqueued_at;
+        bool coalesce;
+    };
+
+    static ENetHost* create_host(std::uint16_t port, std::size_t max_sessions);
+
+    [[nodiscard]] ISessionWorker* least_loaded_worker() const;
+    void wake();
+    void drain_outbound();
+    void apply(const Outbound& outbound);
+    void release_held();
 
 private:
     core::Config& config_;
+    core::EventLoop& event_loop_;
+
+    RouteTable routes_;
+    std::vector<ISessionWorker*> workers_;
+
+    std::unordered_map<std::uint32_t, std::shared_ptr<Session>> sessions_;
+    std::uint32_t next_session_id_;
+
+    utils::MpscQueue<Outbound> outbound_;
+
+    // Set by the first send() or disconnect() after a drain, later ones skip the wake-up syscall
+    std::atomic<bool> wake_pending_;
 
-    event::Dispatcher& dispatcher_;
-    ENetPeer* peer_;
+    // Coalesced sends waiting for their window, oldest first
+    std::vector<Outbound> held_;
+    std::chrono::microseconds coalesce_window_;
 };
 }
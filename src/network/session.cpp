@@ -0,0 +1,46 @@
+#include "session.hpp"
+
+#include "../utils/network.hpp"
+
+namespace network {
+Session::Session(
+    const std::uint32_t id,
+    ENetPeer* peer,
+    Server& server,
+    core::Config& config,
+    ISessionWorker& worker
+)
+    : id_{ id }
+    , address_{ utils::network::format_ip_address(peer->address.host) }
+    , worker_{ worker }
+    , downstream_{ server, peer }
+    , upstream_{ config, worker.dispatcher(), *this }
+{
+
+}
+
+bool Session::inject(const event::Direction direction, const std::span<const std::byte> data, const int channel)
+{
+    if (direction == event::Direction::ClientBound) {
+        return downstream_.write(data, channel);
+    }
+
+    if (!upstream_.inject(data, channel)) {
+        return false;
+    }
+
+    worker_.wake();
+    return true;
+}
+
+bool Session::inject(const event::Direction direction, packet::IPacket& packet)
+{
+    auto data{ packet::PacketHelper::serialize(packet) };
+    if (data.empty()) {
+        return false;
+    }
+
+    data.push_back(static_cast<std::byte>(0x00));
+    return inject(direction, data, packet.channel());
+}
+}
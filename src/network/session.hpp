@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <enet/enet.h>
+
+#include "client.hpp"
+#include "peer_connection.hpp"
+#include "session_worker.hpp"
+#include "../core/config.hpp"
+#include "../event/event.hpp"
+#include "../utils/types.hpp"
+#include "../world/world.hpp"
+
+namespace network {
+class Server;
+
+// One proxied player: the downstream Growtopia client peer and its own upstream client host.
+class Session final : public std::enable_shared_from_this<Session>, public utils::types::Immobile {
+public:
+    Session(std::uint32_t id, ENetPeer* peer, Server& server, core::Config& config, ISessionWorker& worker);
+
+    [[nodiscard]] std::uint32_t id() const { return id_; }
+    [[nodiscard]] const std::string& address() const { return address_; }
+    [[nodiscard]] ISessionWorker& worker() const { return worker_; }
+
+    [[nodiscard]] PeerConnection& downstream() { return downstream_; }
+    [[nodiscard]] const PeerConnection& downstream() const { return downstream_; }
+
+    [[nodiscard]] Client& upstream() { return upstream_; }
+    [[nodiscard]] const Client& upstream() const { return upstream_; }
+
+    // The client logs in to the proxy first, its login packet tells which upstream route it belongs
+    // to. The login is held back until the Growtopia server greets the new upstream connection.
+    [[nodiscard]] bool is_routed() const { return routed_; }
+    void hold_login(std::vector<std::byte> login)
+    {
+        routed_ = true;
+        held_login_ = std::move(login);
+    }
+    [[nodiscard]] std::optional<std::vector<std::byte>> take_held_login() { return std::exchange(held_login_, std::nullopt); }
+
+    // Only touched from the session's shard, like everything above
+    [[nodiscard]] world::World& world() { return world_; }
+    [[nodiscard]] const world::World& world() const { return world_; }
+
+    // Thread-safe, for code running outside the session's shard such as scheduler tasks, the web
+    // server or other worker threads. Client-bound packets go through the acceptor's queue,
+    // server-bound ones through the upstream client's, both are sent just before the next flush
+    // of their host. Packets injected from one thread keep their order per direction.
+    bool inject(event::Direction direction, std::span<const std::byte> data, int channel = 0);
+    bool inject(event::Direction direction, packet::IPacket& packet);
+
+    // Both sides are gone, the owning worker may drop the session.
+    [[nodiscard]] bool is_closed() const { return !downstream_.is_active() && !upstream_.is_active(); }
+
+private:
+    std::uint32_t id_;
+    std::string address_;
+    ISessionWorker& worker_;
+
+    PeerConnection downstream_;
+    Client upstream_;
+
+    bool routed_{ false };
+    std::optional<std::vector<std::byte>> held_login_;
+
+    world::World world_;
+};
+}
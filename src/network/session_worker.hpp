@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <enet/enet.h>
+
+#include "../event/event.hpp"
+
+namespace network {
+class Session;
+
+struct SessionMessage {
+    enum class Type {
+        Connect,
+        Receive,
+        Disconnect
+    };
+
+    Type type;
+    std::shared_ptr<Session> session;
+    // Received packet, owned by the message until the worker wraps it in a network::ReceivedPacket
+    ENetPacket* packet;
+    enet_uint8 channel{ 0 };
+};
+
+// Owner of a group of sessions, network::Server hands every accepted peer to the least loaded one.
+class ISessionWorker {
+public:
+    virtual ~ISessionWorker() = default;
+
+    [[nodiscard]] virtual event::Dispatcher& dispatcher() = 0;
+    [[nodiscard]] virtual std::size_t load() const = 0;
+
+    // Called from the acceptor thread, the worker dispatches the message on its own thread.
+    virtual void post(SessionMessage message) = 0;
+
+    // Thread-safe, runs the task on the worker's thread during its next round. Work from other
+    // threads that touches a session's upstream, its world or the Lua state has to go through here.
+    virtual void execute(std::function<void()> task) = 0;
+
+    // Thread-safe, makes the worker run a round soon, e.g. to flush packets injected into a session
+    virtual void wake() = 0;
+
+    // Worker thread only. The session currently being dispatched, or the one the running script timer
+    // was scheduled from. Null anywhere else, code running outside of those has to name its session.
+    [[nodiscard]] virtual std::shared_ptr<Session> active_session() const = 0;
+
+    // Worker thread only, null if no session with that id lives on this worker
+    [[nodiscard]] virtual std::shared_ptr<Session> find_session(std::uint32_t id) const = 0;
+};
+}
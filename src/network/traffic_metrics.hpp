@@ -0,0 +1,212 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <enet/enet.h>
+
+#include "../event/event.hpp"
+#include "../utils/singleton.hpp"
+
+namespace network {
+// Counters of the outbound queues of one direction, updated from any thread.
+class OutboundMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+        std::uint64_t depth;
+        std::uint64_t enqueued;
+        std::uint64_t sent;
+        std::uint64_t dropped;
+        std::chrono::nanoseconds total_latency;
+        std::chrono::nanoseconds max_latency;
+
+        // Enqueue to enet_peer_send, averaged over the packets that were sent
+        [[nodiscard]] std::chrono::nanoseconds avg_latency() const
+        {
+            return sent ? total_latency / static_cast<std::int64_t>(sent) : std::chrono::nanoseconds{ 0 };
+        }
+    };
+
+    void on_enqueue()
+    {
+        depth_.fetch_add(1, std::memory_order_relaxed);
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void on_send(const Clock::time_point enqueued_at)
+    {
+        const auto latency{ std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - enqueued_at).count() };
+
+        depth_.fetch_sub(1, std::memory_order_relaxed);
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        total_latency_.fetch_add(latency, std::memory_order_relaxed);
+
+        auto max{ max_latency_.load(std::memory_order_relaxed) };
+        while (latency > max && !max_latency_.compare_exchange_weak(max, latency, std::memory_order_relaxed)) { }
+    }
+
+    void on_drop()
+    {
+        depth_.fetch_sub(1, std::memory_order_relaxed);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Snapshot snapshot() const
+    {
+        return {
+            static_cast<std::uint64_t>(std::max<std::int64_t>(depth_.load(std::memory_order_relaxed), 0)),
+            enqueued_.load(std::memory_order_relaxed),
+            sent_.load(std::memory_order_relaxed),
+            dropped_.load(std::memory_order_relaxed),
+            std::chrono::nanoseconds{ total_latency_.load(std::memory_order_relaxed) },
+            std::chrono::nanoseconds{ max_latency_.load(std::memory_order_relaxed) }
+        };
+    }
+
+    // Depth is a gauge of what is queued right now and is left alone
+    void reset()
+    {
+        enqueued_.store(0, std::memory_order_relaxed);
+        sent_.store(0, std::memory_order_relaxed);
+        dropped_.store(0, std::memory_order_relaxed);
+        total_latency_.store(0, std::memory_order_relaxed);
+        max_latency_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Signed, a racing reader may see a send before its enqueue
+    std::atomic<std::int64_t> depth_{ 0 };
+    std::atomic<std::uint64_t> enqueued_{ 0 };
+    std::atomic<std::uint64_t> sent_{ 0 };
+    std::atomic<std::uint64_t> dropped_{ 0 };
+    std::atomic<std::int64_t> total_latency_{ 0 };
+    std::atomic<std::int64_t> max_latency_{ 0 };
+};
+
+// UDP datagrams the ENet hosts of one direction put on the wire, including acknowledgements and
+// retransmits. Fewer, fuller datagrams for the same traffic is what coalescing is after.
+class DatagramMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Snapshot {
+        std::uint64_t datagrams;
+        std::uint64_t bytes;
+        std::chrono::duration<double> elapsed;
+
+        [[nodiscard]] double per_second() const
+        {
+            return elapsed.count() > 0.0 ? static_cast<double>(datagrams) / elapsed.count() : 0.0;
+        }
+
+        [[nodiscard]] double bytes_per_datagram() const
+        {
+            return datagrams ? static_cast<double>(bytes) / static_cast<double>(datagrams) : 0.0;
+        }
+    };
+
+    // Moves the counters ENet keeps on the host into these. Called on the host's thread right after
+    // it was flushed, every host counts into the metrics of its direction.
+    void collect(ENetHost& host)
+    {
+        if (host.totalSentPackets == 0) {
+            return;
+        }
+
+        datagrams_.fetch_add(host.totalSentPackets, std::memory_order_relaxed);
+        bytes_.fetch_add(host.totalSentData, std::memory_order_relaxed);
+        host.totalSentPackets = 0;
+        host.totalSentData = 0;
+    }
+
+    [[nodiscard]] Snapshot snapshot() const
+    {
+        const Clock::time_point since{ Clock::duration{ since_.load(std::memory_order_relaxed) } };
+        return {
+            datagrams_.load(std::memory_order_relaxed),
+            bytes_.load(std::memory_order_relaxed),
+            Clock::now() - since
+        };
+    }
+
+    void reset()
+    {
+        datagrams_.store(0, std::memory_order_relaxed);
+        bytes_.store(0, std::memory_order_relaxed);
+        since_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> datagrams_{ 0 };
+    std::atomic<std::uint64_t> bytes_{ 0 };
+    std::atomic<Clock::rep> since_{ Clock::now().time_since_epoch().count() };
+};
+
+// Received packets handed to the acceptor thread for a downstream peer. The hand-off only moves
+// the ENet packet while nothing else holds a share of it when the dispatch ends, otherwise the
+// packet is copied. A growing copy count means something keeps shares past the dispatch.
+class ForwardMetrics {
+public:
+    struct Snapshot {
+        std::uint64_t handed_off;
+        std::uint64_t copied;
+    };
+
+    void on_hand_off(const bool copied)
+    {
+        (copied ? copied_ : handed_off_).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] Snapshot snapshot() const
+    {
+        return {
+            handed_off_.load(std::memory_order_relaxed),
+            copied_.load(std::memory_order_relaxed)
+        };
+    }
+
+    void reset()
+    {
+        handed_off_.store(0, std::memory_order_relaxed);
+        copied_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint64_t> handed_off_{ 0 };
+    std::atomic<std::uint64_t> copied_{ 0 };
+};
+
+// Process-wide network counters, summed over every shard and session.
+class TrafficMetrics : public utils::Singleton<TrafficMetrics> {
+public:
+    [[nodiscard]] OutboundMetrics& outbound(const event::Direction direction)
+    {
+        return direction == event::Direction::ClientBound ? client_bound_ : server_bound_;
+    }
+
+    [[nodiscard]] DatagramMetrics& datagrams(const event::Direction direction)
+    {
+        return direction == event::Direction::ClientBound ? client_bound_datagrams_ : server_bound_datagrams_;
+    }
+
+    [[nodiscard]] ForwardMetrics& forwards() { return forwards_; }
+
+    void reset()
+    {
+        client_bound_.reset();
+        server_bound_.reset();
+        client_bound_datagrams_.reset();
+        server_bound_datagrams_.reset();
+        forwards_.reset();
+    }
+
+private:
+    OutboundMetrics client_bound_;
+    OutboundMetrics server_bound_;
+    DatagramMetrics client_bound_datagrams_;
+    DatagramMetrics server_bound_datagrams_;
+    ForwardMetrics forwards_;
+};
+}
@@ -6,8 +6,6 @@
 
 namespace packet::game {
 struct SendInventoryState : GamePacket<PacketId::SendInventoryState, PACKET_SEND_INVENTORY_STATE> {
-    std::vector<std::byte> extra;
-
     [[nodiscard]] bool read(const Payload& payload) override
     {
         const auto* game_payload = std::get_if<GamePayload>(&payload);
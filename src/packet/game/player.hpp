@@ -14,19 +14,11 @@ struct OnNameChanged : VariantPacket<PacketId::OnNameChanged> {
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
+        if (!read_variant(payload, 2)) {
             return false;
         }
 
-        variant = var->variant;
-        game_packet = var->game_packet;
-
-        if (variant.size() < 2) {
-            return false;
-        }
-
-        name = variant.get<std::string>(1);
+        name = argument(1);
         return true;
     }
 
@@ -54,19 +46,11 @@ struct OnChangeSkin : VariantPacket<PacketId::OnChangeSkin> {
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
-            return false;
-        }
-
-        variant = var->variant;
-        game_packet = var->game_packet;
-
-        if (variant.size() < 2) {
+        if (!read_variant(payload, 2)) {
             return false;
         }
 
-        skin_code = variant.get<uint32_t>(1);
+        skin_code = argument<uint32_t>(1);
         return true;
     }
 
@@ -29,34 +29,25 @@ struct OnSendToServer : VariantPacket<PacketId::OnSendToServer> {
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
+        if (!read_variant(payload, 5)) {
             return false;
         }
 
-        variant = var->variant;
-        game_packet = var->game_packet;
+        port = argument<int32_t>(1);
+        token = argument<int32_t>(2);
+        user = argument<int32_t>(3);
 
-        if (variant.size() < 5) {
-            return false;
-        }
-
-        port = variant.get<int32_t>(1);
-        token = variant.get<int32_t>(2);
-        user = variant.get<int32_t>(3);
+        const auto raw_text{ argument(4) };
+        const auto key{ raw_text.substr(0, raw_text.find_first_of('|')) };
 
-        const std::string raw_text{ variant.get<std::string>(4) };
-        const std::string key{ raw_text.substr(0, raw_text.find_first_of('|')) };
-
-        utils::TextParse text_parse{};
-        text_parse.parse(raw_text);
+        const utils::TextParseView text_parse{ raw_text };
 
         address = key;
         door_id = text_parse.get(key, 0);
         uuid_token = text_parse.get(key, 1);
 
-        login_mode = variant.get<uint32_t>(5);
-        username = variant.get<std::string>(6);
+        login_mode = argument<uint32_t>(5);
+        username = argument(6);
         return true;
     }
 
@@ -87,23 +78,15 @@ struct OnSuperMainStartAcceptLogonHrdxs47254722215a : VariantPacket<PacketId::On
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
-            return false;
-        }
-
-        variant = var->variant;
-        game_packet = var->game_packet;
-
-        if (variant.size() < 4) {
+        if (!read_variant(payload, 4)) {
             return false;
         }
 
-        item_hash = variant.get<int32_t>(1);
-        u = variant.get<std::string>(2);
-        uu = variant.get<std::string>(3);
-        uuu = variant.get<std::string>(4);
-        player_tribute_hash = variant.get<uint32_t>(5);
+        item_hash = argument<int32_t>(1);
+        u = argument(2);
+        uu = argument(3);
+        uuu = argument(4);
+        player_tribute_hash = argument<uint32_t>(5);
 
         return true;
     }
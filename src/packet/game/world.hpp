@@ -3,6 +3,7 @@
 #include "../packet_id.hpp"
 #include "../packet_helper.hpp"
 #include "../../utils/text_parse.hpp"
+#include "../../utils/text_parse_view.hpp"
 
 namespace packet::game {
 struct OnSpawn : VariantPacket<PacketId::OnSpawn> {
@@ -35,21 +36,11 @@ struct OnSpawn : VariantPacket<PacketId::OnSpawn> {
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
+        if (!read_variant(payload, 2)) {
             return false;
         }
 
-        variant = var->variant;
-        game_packet = var->game_packet;
-
-        if (variant.size() < 2) {
-            return false;
-        }
-
-        utils::TextParse parser{};
-        const std::string data{ variant.get<std::string>(1) };
-        parser.parse(data);
+        const utils::TextParseView parser{ argument(1) };
 
         spawn = parser.get("spawn", 0);
         net_id = parser.get<int32_t>("netID", 0);
@@ -114,29 +105,17 @@ struct OnRemove : VariantPacket<PacketId::OnRemove> {
 
     bool read(const Payload& payload) override
     {
-        const auto var{ get_payload_if<VariantPayload>(payload) };
-        if (!var) {
+        if (!read_variant(payload, 3)) {
             return false;
         }
 
-        variant = var->variant;
-        game_packet = var->game_packet;
-
-        if (variant.size() < 3) {
-            return false;
-        }
-
-        utils::TextParse parser{};
-
-        const std::string net_id_data{ variant.get<std::string>(1) };
-        parser.parse(net_id_data);
+        utils::TextParseView parser{ argument(1) };
 
         if (parser.contains("netID")) {
             net_id = parser.get<int32_t>("netID", 0);
         }
 
-        const std::string player_id_data{ variant.get<std::string>(2) };
-        parser.parse(player_id_data);
+        parser.parse(argument(2));
 
         if (parser.contains("pId")) {
             player_id = parser.get<int32_t>("pId", 0);
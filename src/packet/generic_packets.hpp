@@ -9,12 +9,11 @@ struct GenericTextPacket : TextPacket<PacketId::Unknown> {
 
     [[nodiscard]] bool read(const Payload& payload) override
     {
-        const auto* text = get_payload_if<TextPayload>(payload);
+        const auto* text = read_text(payload);
         if (!text) {
             return false;
         }
 
-        text_parse = text->data;
         message_type = text->message_type;
         raw_data = text->raw_data;
         return true;
@@ -22,27 +21,24 @@ struct GenericTextPacket : TextPacket<PacketId::Unknown> {
 
     [[nodiscard]] Payload write() override
     {
-        return TextPayload{ message_type, text_parse };
+        return TextPayload{ message_type, text_parse() };
     }
 };
 
 struct GenericVariantPacket : VariantPacket<PacketId::Unknown> {
     [[nodiscard]] bool read(const Payload& payload) override
     {
-        const auto* var = get_payload_if<VariantPayload>(payload);
-        if (!var) {
+        if (!read_variant(payload)) {
             return false;
         }
 
-        variant = var->variant;
-        game_packet = var->game_packet;
-        raw_data = var->raw_data;
+        raw_data = get_payload<VariantPayload>(payload).raw_data;
         return true;
     }
 
     [[nodiscard]] Payload write() override
     {
-        return VariantPayload{ game_packet, variant };
+        return VariantPayload{ game_packet, variant() };
     }
 };
 
@@ -7,14 +7,12 @@ struct Log : TextPacket<PacketId::Log> {
 
     bool read(const Payload& payload) override
     {
-        const auto text{ get_payload_if<TextPayload>(payload) };
+        const auto text{ read_text(payload) };
         if (!text) {
             return false;
         };
 
-        text_parse = text->data;
-        
-        msg = text_parse.get("msg", 1);
+        msg = text->get("msg", 1);
         return true;
     }
 
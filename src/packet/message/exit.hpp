@@ -5,13 +5,7 @@ namespace packet::message {
 struct Quit : TextPacket<PacketId::Quit> {
     bool read(const Payload& payload) override
     {
-        const auto text{ get_payload_if<TextPayload>(payload) };
-        if (!text) {
-            return false;
-        }
-
-        text_parse = text->data;
-        return true;
+        return read_text(payload) != nullptr;
     }
 
     Payload write() override
@@ -25,13 +19,7 @@ struct Quit : TextPacket<PacketId::Quit> {
 struct QuitToExit : TextPacket<PacketId::QuitToExit> {
     bool read(const Payload& payload) override
     {
-        const auto text{ get_payload_if<TextPayload>(payload) };
-        if (!text) {
-            return false;
-        }
-
-        text_parse = text->data;
-        return true;
+        return read_text(payload) != nullptr;
     }
 
     Payload write() override
@@ -48,15 +36,13 @@ struct JoinRequest : TextPacket<PacketId::JoinRequest> {
 
     bool read(const Payload& payload) override
     {
-        const auto text{ get_payload_if<TextPayload>(payload) };
+        const auto text{ read_text(payload) };
         if (!text) {
             return false;
         }
 
-        text_parse = text->data;
-        
-        world_name = text_parse.get("name", 0);
-        invited_world = text_parse.get("invitedWorld", 0) == "1";
+        world_name = text->get("name", 0);
+        invited_world = text->get("invitedWorld", 0) == "1";
         return true;
     }
 
@@ -75,14 +61,12 @@ struct ValidateWorld : TextPacket<PacketId::ValidateWorld> {
 
     bool read(const Payload& payload) override
     {
-        const auto text{ get_payload_if<TextPayload>(payload) };
+        const auto text{ read_text(payload) };
         if (!text) {
             return false;
         }
 
-        text_parse = text->data;
-        
-        world_name = text_parse.get("name", 1);
+        world_name = text->get("name", 1);
         return true;
     }
 
@@ -7,14 +7,13 @@ struct Input : TextPacket<PacketId::Input, NET_MESSAGE_GENERIC_TEXT> {
 
     bool read(const Payload& payload) override
     {
-        const auto text_payload{ get_payload_if<TextPayload>(payload) };
+        const auto text_payload{ read_text(payload) };
         if (!text_payload) {
             return false;
         }
 
-        text_parse = text_payload->data;
-
-        text = text_parse.get("text", 0);
+        // Scripts read the rest through text_parse
+        text = text_payload->get("text", 0);
         return true;
     }
 
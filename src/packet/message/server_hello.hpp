@@ -5,13 +5,7 @@ namespace packet::message {
 struct ServerHello : TextPacket<PacketId::ServerHello, NET_MESSAGE_SERVER_HELLO> {
     bool read(const Payload& payload) override
     {
-        const auto* text{ get_payload_if<TextPayload>(payload) };
-        if (!text) {
-            return false;
-        }
-
-        text_parse = text->data;
-        return true;
+        return read_text(payload) != nullptr;
     }
     
     Payload write() override
@@ -1,13 +1,97 @@
 #include "packet_decoder.hpp"
 
+#include <cstddef>
+#include <cstring>
 #include <magic_enum/magic_enum.hpp>
 
 #include "../utils/formatter/packet_variant_formatter.hpp"
 #include "../utils/formatter/text_parse_formatter.hpp"
+#include "../utils/text_parse_view.hpp"
 
 namespace packet {
+namespace {
+PacketId classify_variant(const std::span<const std::byte> extra)
+{
+    // count, index, type, then the length prefixed function name
+    constexpr std::size_t name_offset{ 3 + sizeof(uint32_t) };
+    if (extra.size() < name_offset || static_cast<VariantType>(extra[2]) != VariantType::STRING) {
+        return PacketId::Unknown;
+    }
+
+    uint32_t length{ 0 };
+    std::memcpy(&length, extra.data() + 3, sizeof(length));
+    if (length > extra.size() - name_offset) {
+        return PacketId::Unknown;
+    }
+
+    const std::string_view name{ reinterpret_cast<const char*>(extra.data() + name_offset), length };
+    if (const auto it{ VARIANT_FUNCTION_MAP.find(name) }; it != VARIANT_FUNCTION_MAP.end()) {
+        return it->second;
+    }
+
+    return PacketId::Unknown;
+}
+}
+
+std::optional<PacketDecoder::Classification> PacketDecoder::classify(const std::span<const std::byte> data)
+{
+    NetMessageType msg_type{};
+    if (data.size() < sizeof(msg_type)) {
+        return std::nullopt;
+    }
+
+    std::memcpy(&msg_type, data.data(), sizeof(msg_type));
+    const auto body{ data.subspan(sizeof(msg_type)) };
+
+    switch (msg_type) {
+    case NET_MESSAGE_SERVER_HELLO:
+        return Classification{ msg_type, PACKET_STATE, PacketId::ServerHello };
+    case NET_MESSAGE_GENERIC_TEXT:
+    case NET_MESSAGE_GAME_MESSAGE: {
+        // Same bounds as decode(), the last byte is the null terminator
+        const std::string_view text{
+            reinterpret_cast<const char*>(body.data()),
+            body.empty() ? 0 : body.size() - 1
+        };
+
+        return Classification{ msg_type, PACKET_STATE, text_action::match(text) };
+    }
+    case NET_MESSAGE_GAME_PACKET: {
+        if (body.size() < sizeof(GameUpdatePacket)) {
+            return std::nullopt;
+        }
+
+        const auto game_type{ static_cast<PacketType>(body[offsetof(GameUpdatePacket, type)]) };
+        if (game_type == PACKET_CALL_FUNCTION) {
+            return Classification{ msg_type, game_type, classify_variant(body.subspan(sizeof(GameUpdatePacket))) };
+        }
+
+        return Classification{ msg_type, game_type, game_packet_id(game_type) };
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+bool PacketDecoder::is_logged(const Classification& classification, const core::Config::LogConfig& log_config)
+{
+    switch (classification.message_type) {
+    case NET_MESSAGE_GENERIC_TEXT:
+    case NET_MESSAGE_GAME_MESSAGE:
+        return log_config.print_message;
+    case NET_MESSAGE_GAME_PACKET:
+        if (log_config.print_game_update_packet) {
+            return true;
+        }
+
+        return classification.game_type == PACKET_CALL_FUNCTION ? log_config.print_variant : log_config.print_extra;
+    default:
+        return false;
+    }
+}
+
 [[nodiscard]] std::optional<std::shared_ptr<IPacket>> PacketDecoder::decode(
-    std::span<const std::byte> data,
+    const utils::SharedBytes& data,
     const core::Config::LogConfig& log_config,
     std::string_view direction
 ) {
@@ -34,10 +118,10 @@ namespace packet {
     }
     case NET_MESSAGE_GENERIC_TEXT:
     case NET_MESSAGE_GAME_MESSAGE: {
-        std::string message{};
-        stream.read(message, static_cast<uint16_t>(stream.get_size() - sizeof(NetMessageType) - 1));
+        // Parsed in place, the last byte is the null terminator
+        const auto message{ TextPayload::message_of(data) };
 
-        utils::TextParse parser{ message };
+        utils::TextParseView parser{ message };
         if (log_config.print_message) {
             spdlog::info(
                 "{} ({} bytes):\n{}",
@@ -65,11 +149,8 @@ namespace packet {
                  : stream.get_size() - stream.get_read_offset()
         );
 
-        // Create a view of the extra data
-        std::span<const std::byte> extra_view{
-            data.data() + stream.get_read_offset(),
-            stream.get_size() - stream.get_read_offset()
-        };
+        // Shares the received buffer, payloads never copy it
+        const auto extra_view{ data.subspan(stream.get_read_offset()) };
 
         spdlog::info(
             "{} with type of {}",
@@ -92,22 +173,35 @@ namespace packet {
         stream.skip(extra_size);
 
         if (game_pkt.type == PACKET_CALL_FUNCTION) {
-            PacketVariant variant{};
-            if (!variant.deserialize(extra_view)) {
-                return std::nullopt;
+            Payload payload{ RawPayload{} };
+            if (PacketVariantView::fits(extra_view)) {
+                // Slots point into the received bytes, the payload keeps them alive through raw_data
+                PacketVariantView variant{};
+                if (!variant.deserialize(extra_view)) {
+                    return std::nullopt;
+                }
+
+                if (log_config.print_variant) {
+                    spdlog::info("{}", variant);
+                }
+
+                payload = VariantPayload{ game_pkt, variant, data };
             }
-
-            if (log_config.print_variant) {
-                spdlog::info("{}", variant);
+            else {
+                // More arguments than the view has slots, rare enough to pay for an owning copy
+                PacketVariant variant{};
+                if (!variant.deserialize(extra_view)) {
+                    return std::nullopt;
+                }
+
+                spdlog::debug("Variant with {} arguments decoded into an owning PacketVariant", variant.size());
+                if (log_config.print_variant) {
+                    spdlog::info("{}", variant);
+                }
+
+                payload = VariantPayload{ game_pkt, std::move(variant), data };
             }
 
-            VariantPayload var_payload{ 
-                game_pkt, 
-                std::move(variant), 
-                data 
-            };
-            Payload payload = var_payload;
-
             auto packet = PacketRegistry::instance().create(payload);
             if (!packet) {
                 return std::nullopt;
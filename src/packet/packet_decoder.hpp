@@ -13,8 +13,22 @@
 namespace packet {
 class PacketDecoder {
 public:
+    struct Classification {
+        NetMessageType message_type;
+        PacketType game_type;
+        PacketId id;
+    };
+
+    // Looks only at the message type, the GameUpdatePacket type byte, the text action or the variant
+    // function name, without allocating. PacketId::Unknown means decode() cannot produce a packet
+    // with a typed event, a known id is only a hint that decode() confirms.
+    [[nodiscard]] static std::optional<Classification> classify(std::span<const std::byte> data);
+
+    // Whether the log config asks decode() to print packets of this kind.
+    [[nodiscard]] static bool is_logged(const Classification& classification, const core::Config::LogConfig& log_config);
+
     [[nodiscard]] static std::optional<std::shared_ptr<IPacket>> decode(
-        std::span<const std::byte> data,
+        const utils::SharedBytes& data,
         const core::Config::LogConfig& log_config,
         std::string_view direction
     );
@@ -1,18 +1,28 @@
 #pragma once
-#include <functional>
+#include <array>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
-#include <utility>
+#include <span>
 
 #include "packet_id.hpp"
 #include "../event/event.hpp"
+#include "../utils/object_pool.hpp"
 
 namespace packet::event_registry {
-using PacketEventBuilder = std::function<std::shared_ptr<event::Event>(
+using PacketEventBuilder = std::shared_ptr<event::Event>(*)(
     event::PriorityEventDispatcher&,
     event::Direction,
-    std::shared_ptr<IPacket>
-)>;
+    const std::shared_ptr<IPacket>&,
+    network::Session*
+);
+
+// Copies a decoded packet for observers, detached from the received buffer
+using PacketSnapshotBuilder = std::shared_ptr<const IPacket>(*)(const IPacket&);
+
+struct PacketEventEntry {
+    PacketEventBuilder build{ nullptr };
+    PacketSnapshotBuilder snapshot{ nullptr };
+};
 
 class PacketEventRegistry {
 public:
@@ -22,50 +32,112 @@ public:
         return registry;
     }
 
-    void register_event(PacketId id, PacketEventBuilder builder)
+    void register_event(const PacketId id, const PacketEventEntry entry)
+    {
+        if (const auto index{ dense_index(id) }; index != INVALID_DENSE_INDEX) {
+            entries_[index] = entry;
+        }
+    }
+
+    [[nodiscard]] bool has_event(const PacketId id) const
     {
-        builders_[id] = std::move(builder);
+        return find(id).build != nullptr;
     }
 
-    [[nodiscard]] bool has_event(PacketId id) const
+    // A typed event for this packet would reach at least one listener or observer, so decoding it is
+    // worth it.
+    [[nodiscard]] bool is_observed(const event::PriorityEventDispatcher& dispatcher, const PacketId id) const
     {
-        return builders_.find(id) != builders_.end();
+        const auto type{ event::packet_event_type(id) };
+        return has_event(id) && (dispatcher.has_listeners(type) || dispatcher.has_observers(type));
     }
 
     [[nodiscard]] std::shared_ptr<event::Event> emit(
         event::PriorityEventDispatcher& dispatcher,
         const event::Direction direction,
-        const std::shared_ptr<IPacket>& packet
+        const std::shared_ptr<IPacket>& packet,
+        network::Session* session = nullptr
     ) const {
-        const auto it{ builders_.find(packet->id()) };
-        if (it == builders_.end()) {
+        const auto builder{ find(packet->id()).build };
+        if (!builder) {
             return nullptr;
         }
 
-        return it->second(dispatcher, direction, packet);
+        return builder(dispatcher, direction, packet, session);
+    }
+
+    // Called once a packet has been forwarded, queues copies of it for the observers of its raw and
+    // typed events. Nothing is copied for types nobody observes.
+    void observe(
+        event::PriorityEventDispatcher& dispatcher,
+        const event::Direction direction,
+        const std::uint32_t session_id,
+        const std::span<const std::byte> data,
+        const std::shared_ptr<IPacket>& packet = nullptr
+    ) const {
+        if (const auto raw_type{ event::raw_packet_type(direction) }; dispatcher.has_observers(raw_type)) {
+            dispatcher.defer({ raw_type, direction, session_id, nullptr, utils::SharedBytes::copy_of(data) });
+        }
+
+        if (!packet) {
+            return;
+        }
+
+        const auto type{ event::packet_event_type(packet->id()) };
+        const auto snapshot{ find(packet->id()).snapshot };
+        if (snapshot && dispatcher.has_observers(type)) {
+            dispatcher.defer({ type, direction, session_id, snapshot(*packet), {} });
+        }
     }
 
 private:
     PacketEventRegistry() = default;
 
-    std::unordered_map<PacketId, PacketEventBuilder> builders_;
+    [[nodiscard]] PacketEventEntry find(const PacketId id) const
+    {
+        const auto index{ dense_index(id) };
+        return index != INVALID_DENSE_INDEX ? entries_[index] : PacketEventEntry{};
+    }
+
+private:
+    std::array<PacketEventEntry, DENSE_PACKET_ID_COUNT> entries_{};
 };
 
 template<typename PacketType, PacketId PacketTypeId>
-PacketEventBuilder make_event_builder()
+PacketEventEntry make_event_builder()
 {
-    return [](
+    const PacketEventBuilder build = [](
         event::PriorityEventDispatcher& dispatcher,
         const event::Direction direction,
-        const std::shared_ptr<IPacket>& packet
+        const std::shared_ptr<IPacket>& packet,
+        network::Session* session
     ) -> std::shared_ptr<event::Event> {
         auto typed_packet{ std::static_pointer_cast<PacketType>(packet) };
-        auto evt = std::make_shared<event::TypedPacketEvent<PacketTypeId>>(
+        auto evt = utils::make_pooled<event::TypedPacketEvent<PacketTypeId>>(
             direction,
-            std::move(typed_packet)
+            std::move(typed_packet),
+            session
         );
         dispatcher.dispatch(*evt);
         return evt;
     };
+
+    const PacketSnapshotBuilder snapshot = [](const IPacket& packet) -> std::shared_ptr<const IPacket> {
+        auto copy{ utils::make_pooled<PacketType>(static_cast<const PacketType&>(packet)) };
+        copy->raw_data = utils::SharedBytes::copy_of(copy->raw_data);
+        if constexpr (requires { copy->extra; }) {
+            copy->extra = utils::SharedBytes::copy_of(copy->extra);
+        }
+        if constexpr (requires { copy->own_arguments(); }) {
+            copy->own_arguments();
+        }
+        if constexpr (requires { copy->own_text(); }) {
+            copy->own_text();
+        }
+
+        return copy;
+    };
+
+    return { build, snapshot };
 }
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <type_traits>
 #include <concepts>
+#include <optional>
 #include <span>
 
 #include <magic_enum/magic_enum.hpp>
@@ -27,7 +28,8 @@ public:
     [[nodiscard]] virtual bool read(const Payload& payload) = 0;
     [[nodiscard]] virtual Payload write() = 0;
 
-    std::vector<std::byte> raw_data;
+    // Shares the received buffer, so a packet that keeps it alive also keeps the ENet packet alive
+    utils::SharedBytes raw_data;
 
     [[nodiscard]] bool has_raw_data() const { return !raw_data.empty(); }
 };
@@ -39,14 +41,52 @@ struct TextPacket : IPacket {
     static constexpr int CHANNEL = Channel;
     using IsTextPacket = std::true_type;
 
-    utils::TextParse text_parse;
-
     [[nodiscard]] PacketId id() const override { return ID; }
     [[nodiscard]] int channel() const override { return CHANNEL; }
 
     [[nodiscard]] std::shared_ptr<IPacket> shared_from_this() {
         return std::shared_ptr<IPacket>(this, [](IPacket*) {});
     }
+
+    // Owning text, parsed from the received bytes the first time a listener or script asks
+    [[nodiscard]] utils::TextParse& text_parse()
+    {
+        if (!text_parse_) {
+            text_parse_ = utils::TextParseView{ TextPayload::message_of(text_source_) }.to_owned();
+            text_source_ = {};
+        }
+
+        return *text_parse_;
+    }
+
+    // Lets go of the received buffer, for copies that outlive the dispatch
+    void own_text() { static_cast<void>(text_parse()); }
+
+protected:
+    // Remembers where the text came from, read() takes its fields from the payload's view and
+    // nothing is copied until text_parse() is called.
+    [[nodiscard]] const TextPayload* read_text(const Payload& payload)
+    {
+        const auto* text{ get_payload_if<TextPayload>(payload) };
+        if (!text) {
+            return nullptr;
+        }
+
+        if (text->view.empty()) {
+            text_parse_ = text->data;
+            text_source_ = {};
+        }
+        else {
+            text_parse_.reset();
+            text_source_ = text->raw_data;
+        }
+
+        return text;
+    }
+
+private:
+    utils::SharedBytes text_source_;
+    std::optional<utils::TextParse> text_parse_;
 };
 
 template <PacketId Id, PacketType PktType, int Channel = 0>
@@ -58,7 +98,7 @@ struct GamePacket : IPacket {
     using IsGamePacket = std::true_type;
 
     GameUpdatePacket game_packet{};
-    std::vector<std::byte> extra;
+    utils::SharedBytes extra;
 
     [[nodiscard]] PacketId id() const override { return ID; }
     [[nodiscard]] int channel() const override { return CHANNEL; }
@@ -76,7 +116,6 @@ struct VariantPacket : IPacket {
     static constexpr int CHANNEL = Channel;
     using IsVariantPacket = std::true_type;
 
-    PacketVariant variant;
     GameUpdatePacket game_packet{};
 
     [[nodiscard]] PacketId id() const override { return ID; }
@@ -85,6 +124,72 @@ struct VariantPacket : IPacket {
     [[nodiscard]] std::shared_ptr<IPacket> shared_from_this() {
         return std::shared_ptr<IPacket>(this, [](IPacket*) {});
     }
+
+    [[nodiscard]] std::size_t argument_count() const
+    {
+        return variant_ ? variant_->size() : view_.size();
+    }
+
+    template <typename T = std::string_view>
+    [[nodiscard]] T argument(const std::size_t index) const
+    {
+        if (!variant_) {
+            return view_.get<T>(index);
+        }
+
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return variant_->get_string_view(index);
+        }
+        else {
+            return variant_->get<T>(index);
+        }
+    }
+
+    // Owning arguments, built from the received ones the first time a listener or script asks
+    [[nodiscard]] PacketVariant& variant()
+    {
+        if (!variant_) {
+            variant_ = view_.to_owned();
+            view_ = {};
+            view_source_ = {};
+        }
+
+        return *variant_;
+    }
+
+    // Lets go of the received buffer, for copies that outlive the dispatch
+    void own_arguments() { static_cast<void>(variant()); }
+
+protected:
+    // Takes the header and arguments of a variant payload. Decoded arguments stay in the received
+    // buffer, nothing is copied until variant() is called.
+    [[nodiscard]] bool read_variant(const Payload& payload, const std::size_t min_arguments = 0)
+    {
+        const auto var{ get_payload_if<VariantPayload>(payload) };
+        if (!var) {
+            return false;
+        }
+
+        game_packet = var->game_packet;
+        if (var->view.empty()) {
+            variant_ = var->variant;
+            view_ = {};
+            view_source_ = {};
+        }
+        else {
+            variant_.reset();
+            view_ = var->view;
+            view_source_ = var->raw_data;
+        }
+
+        return argument_count() >= min_arguments;
+    }
+
+private:
+    PacketVariantView view_;
+    // Keeps the buffer view_ points into alive
+    utils::SharedBytes view_source_;
+    std::optional<PacketVariant> variant_;
 };
 
 struct PacketHelper {
@@ -132,7 +237,7 @@ struct PacketHelper {
     static std::vector<std::byte> serialize(IPacket& packet)
     {
         if (packet.has_raw_data()) {
-            return packet.raw_data;
+            return packet.raw_data.to_vector();
         }
 
         return serialize(packet.write());
@@ -1,9 +1,12 @@
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string_view>
 #include <string>
 #include <unordered_map>
-#include <vector>
-#include <regex>
+#include <utility>
 
 #include "payload.hpp"
 
@@ -36,31 +39,112 @@ enum class PacketId : uint32_t {
     Unknown = std::numeric_limits<uint32_t>::max(),
 };
 
-struct TextRegexPattern {
-    std::string pattern;
+// Ids are grouped per 0x1000 block, each block only uses its first few values. Mapping the group and
+// the offset into a small dense range lets registries use plain arrays indexed by id.
+inline constexpr std::size_t PACKET_ID_GROUP_SIZE{ 16 };
+inline constexpr std::size_t PACKET_ID_GROUP_COUNT{ 4 };
+inline constexpr std::size_t DENSE_PACKET_ID_COUNT{ PACKET_ID_GROUP_SIZE * PACKET_ID_GROUP_COUNT };
+inline constexpr std::size_t INVALID_DENSE_INDEX{ DENSE_PACKET_ID_COUNT };
+
+[[nodiscard]] constexpr std::size_t dense_index(const PacketId id)
+{
+    const auto value{ static_cast<uint32_t>(id) };
+    const std::size_t group{ value >> 12 };
+    const std::size_t offset{ value & 0xFFF };
+    if (group >= PACKET_ID_GROUP_COUNT || offset >= PACKET_ID_GROUP_SIZE) {
+        return INVALID_DENSE_INDEX;
+    }
+
+    return group * PACKET_ID_GROUP_SIZE + offset;
+}
+
+static_assert(dense_index(PacketId::OnChangeSkin) != INVALID_DENSE_INDEX, "PacketId group 1 outgrew PACKET_ID_GROUP_SIZE");
+static_assert(dense_index(PacketId::ItemChangeObject) != INVALID_DENSE_INDEX, "PacketId group 2 outgrew PACKET_ID_GROUP_SIZE");
+static_assert(
+    dense_index(PacketId::OnSuperMainStartAcceptLogonHrdxs47254722215a) != INVALID_DENSE_INDEX,
+    "PacketId group 3 outgrew PACKET_ID_GROUP_SIZE"
+);
+static_assert(dense_index(PacketId::Unknown) == INVALID_DENSE_INDEX);
+
+namespace text_action {
+struct Entry {
+    std::string_view name;
     PacketId id;
-    std::regex compiled;
+};
 
-    TextRegexPattern(std::string_view pat, PacketId packet_id)
-        : pattern{ pat }
-        , id{ packet_id }
-        , compiled{ pattern, std::regex::optimize }
-    { }
+inline constexpr std::array ENTRIES{
+    Entry{ "quit", PacketId::Quit },
+    Entry{ "quit_to_exit", PacketId::QuitToExit },
+    Entry{ "join_request", PacketId::JoinRequest },
+    Entry{ "validate_world", PacketId::ValidateWorld },
+    Entry{ "input", PacketId::Input },
+    Entry{ "log", PacketId::Log },
 };
 
-inline std::vector<TextRegexPattern>& get_text_regex_patterns()
+inline constexpr std::size_t SLOT_COUNT{ 16 };
+
+// Perfect hash over ENTRIES, checked below, so a lookup is one hash, one load and one compare.
+[[nodiscard]] constexpr std::size_t hash(const std::string_view name)
+{
+    return (name.size() * 5 + static_cast<unsigned char>(name.front())) & (SLOT_COUNT - 1);
+}
+
+inline constexpr auto SLOTS{ [] {
+    std::array<const Entry*, SLOT_COUNT> slots{};
+    for (const auto& entry : ENTRIES) {
+        slots[hash(entry.name)] = &entry;
+    }
+
+    return slots;
+}() };
+
+[[nodiscard]] constexpr bool is_perfect()
 {
-    static std::vector<TextRegexPattern> patterns = []() {
-        std::vector<TextRegexPattern> p;
-        p.emplace_back(R"(^action\|quit$)", PacketId::Quit);
-        p.emplace_back(R"(^action\|quit_to_exit$)", PacketId::QuitToExit);
-        p.emplace_back(R"(^action\|join_request$)", PacketId::JoinRequest);
-        p.emplace_back(R"(^action\|validate_world$)", PacketId::ValidateWorld);
-        p.emplace_back(R"(^action\|input)", PacketId::Input);
-        p.emplace_back(R"(^action\|log$)", PacketId::Log);
-        return p;
-    }();
-    return patterns;
+    std::size_t used{ 0 };
+    for (const auto* slot : SLOTS) {
+        used += slot != nullptr;
+    }
+
+    return used == ENTRIES.size();
+}
+
+static_assert(is_perfect(), "text action hash has collisions, adjust text_action::hash");
+
+// Takes the message text as sent on the wire, classifies it by the value of the action key on the
+// first key|value line. The whole line is the value, so "action|quit" never matches "quit_to_exit".
+[[nodiscard]] constexpr PacketId match(std::string_view text)
+{
+    std::string_view line{};
+    while (!text.empty()) {
+        const auto end{ text.find('\n') };
+        line = text.substr(0, end);
+        text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+
+        // Lines without a delimiter are dropped by TextParse as well
+        if (line.find('|') != std::string_view::npos) {
+            break;
+        }
+
+        line = {};
+    }
+
+    constexpr std::string_view key{ "action|" };
+    if (!line.starts_with(key)) {
+        return PacketId::Unknown;
+    }
+
+    auto value{ line.substr(key.size()) };
+    while (!value.empty() && (value.back() == '\r' || value.back() == '\0')) {
+        value.remove_suffix(1);
+    }
+
+    if (value.empty()) {
+        return PacketId::Unknown;
+    }
+
+    const auto* entry{ SLOTS[hash(value)] };
+    return entry && entry->name == value ? entry->id : PacketId::Unknown;
+}
 }
 
 inline const std::unordered_map<std::string_view, PacketId> VARIANT_FUNCTION_MAP = {
@@ -72,7 +156,7 @@ inline const std::unordered_map<std::string_view, PacketId> VARIANT_FUNCTION_MAP
     { "OnSuperMainStartAcceptLogonHrdxs47254722215a", PacketId::OnSuperMainStartAcceptLogonHrdxs47254722215a },
 };
 
-inline const std::unordered_map<PacketType, PacketId> GAME_PACKET_MAP = {
+inline constexpr std::pair<PacketType, PacketId> GAME_PACKET_IDS[]{
     { PACKET_DISCONNECT, PacketId::Disconnect },
     { PACKET_TILE_CHANGE_REQUEST, PacketId::TileChangeRequest },
     { PACKET_SEND_MAP_DATA, PacketId::SendMapData },
@@ -83,36 +167,49 @@ inline const std::unordered_map<PacketType, PacketId> GAME_PACKET_MAP = {
     { PACKET_ITEM_CHANGE_OBJECT, PacketId::ItemChangeObject },
 };
 
+// Indexed by the PacketType byte, every type without a packet of its own maps to PacketId::Unknown.
+inline constexpr auto GAME_PACKET_TABLE{ [] {
+    std::array<PacketId, 256> table{};
+    table.fill(PacketId::Unknown);
+
+    for (const auto& [type, id] : GAME_PACKET_IDS) {
+        table[type] = id;
+    }
+
+    return table;
+}() };
+
+[[nodiscard]] constexpr PacketId game_packet_id(const PacketType type)
+{
+    return GAME_PACKET_TABLE[type];
+}
+
 [[nodiscard]] inline PacketId derive_packet_id(const TextPayload& payload)
 {
     if (payload.message_type == NET_MESSAGE_SERVER_HELLO) {
         return PacketId::ServerHello;
     }
 
-    const std::string raw{ payload.data.get_raw() };
-
-    for (const auto& entry : get_text_regex_patterns()) {
-        if (std::regex_search(raw, entry.compiled)) {
-            return entry.id;
-        }
+    // Decoded payloads keep the wire bytes, only packets built in code need to be serialized first
+    if (payload.raw_data.size() > sizeof(NetMessageType)) {
+        return text_action::match({
+            reinterpret_cast<const char*>(payload.raw_data.data()) + sizeof(NetMessageType),
+            payload.raw_data.size() - sizeof(NetMessageType)
+        });
     }
 
-    return PacketId::Unknown;
+    const std::string raw{ payload.data.get_raw() };
+    return text_action::match(raw);
 }
 
 [[nodiscard]] inline PacketId derive_packet_id(const GamePayload& payload)
 {
-    if (const auto it{ GAME_PACKET_MAP.find(payload.packet.type) }; it != GAME_PACKET_MAP.end()) {
-        return it->second;
-    }
-
-    return PacketId::Unknown;
+    return game_packet_id(payload.packet.type);
 }
 
 [[nodiscard]] inline PacketId derive_packet_id(const VariantPayload& payload)
 {
-    const std::string func_name{ payload.function_name() };
-    if (const auto it{ VARIANT_FUNCTION_MAP.find(func_name) }; it != VARIANT_FUNCTION_MAP.end()) {
+    if (const auto it{ VARIANT_FUNCTION_MAP.find(payload.function_name()) }; it != VARIANT_FUNCTION_MAP.end()) {
         return it->second;
     }
 
@@ -1,8 +1,7 @@
 #pragma once
-#include <functional>
+#include <array>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <fmt/format.h>
 #include <magic_enum/magic_enum.hpp>
 #include <spdlog/spdlog.h>
@@ -10,10 +9,11 @@
 #include "packet_helper.hpp"
 #include "packet_id.hpp"
 #include "generic_packets.hpp"
+#include "../utils/object_pool.hpp"
 #include "../utils/singleton.hpp"
 
 namespace packet {
-using PacketFactory = std::function<std::shared_ptr<IPacket>()>;
+using PacketFactory = std::shared_ptr<IPacket>(*)();
 
 inline std::string packet_name(const PacketId id) {
     if (const auto name = magic_enum::enum_name(id); !name.empty()) {
@@ -32,15 +32,17 @@ public:
             std::is_base_of_v<IPacket, T>,
             "Registered type must derive from IPacket"
         );
+        static_assert(dense_index(T::ID) != INVALID_DENSE_INDEX, "Registered packet id has no dense index");
 
         spdlog::debug("Registering packet: {}", packet_name(T::ID));
-        registry_[T::ID] = [] { return std::make_shared<T>(); };
+        // Pooled, packets are created for nearly every received message and mostly die with its dispatch
+        registry_[dense_index(T::ID)] = []() -> std::shared_ptr<IPacket> { return utils::make_pooled<T>(); };
     }
 
     [[nodiscard]] std::shared_ptr<IPacket> create(const PacketId id) const
     {
-        if (const auto it{ registry_.find(id) }; it != registry_.end()) {
-            return it->second();
+        if (const auto factory{ find(id) }) {
+            return factory();
         }
 
         return nullptr;
@@ -61,18 +63,18 @@ public:
         }
 
         if (const auto* text = get_payload_if<TextPayload>(payload)) {
-            auto generic = std::make_shared<GenericTextPacket>();
+            auto generic = utils::make_pooled<GenericTextPacket>();
             if (generic->read(payload)) {
                 return generic;
             }
         }
         else if (const auto* var = get_payload_if<VariantPayload>(payload)) {
-            if (auto generic = std::make_shared<GenericVariantPacket>(); generic->read(payload)) {
+            if (auto generic = utils::make_pooled<GenericVariantPacket>(); generic->read(payload)) {
                 return generic;
             }
         }
         else if (const auto* game = get_payload_if<GamePayload>(payload)) {
-            if (auto generic = std::make_shared<GenericGamePacket>(); generic->read(payload)) {
+            if (auto generic = utils::make_pooled<GenericGamePacket>(); generic->read(payload)) {
                 return generic;
             }
         }
@@ -82,11 +84,18 @@ public:
 
     [[nodiscard]] bool is_registered(const PacketId id) const
     {
-        return registry_.contains(id);
+        return find(id) != nullptr;
     }
 
 private:
-    std::unordered_map<PacketId, PacketFactory> registry_;
+    [[nodiscard]] PacketFactory find(const PacketId id) const
+    {
+        const auto index{ dense_index(id) };
+        return index != INVALID_DENSE_INDEX ? registry_[index] : nullptr;
+    }
+
+private:
+    std::array<PacketFactory, DENSE_PACKET_ID_COUNT> registry_{};
 };
 }
 
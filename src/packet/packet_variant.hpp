@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 #include <glm/glm.hpp>
@@ -172,6 +173,19 @@ public:
         }
     }
 
+    // View of a string argument, empty if the argument is missing or not a string.
+    [[nodiscard]] std::string_view get_string_view(const std::size_t index) const
+    {
+        if (index >= variants_.size()) {
+            return {};
+        }
+
+        const auto* value{ std::get_if<std::string>(&variants_[index]) };
+        return value ? std::string_view{ *value } : std::string_view{};
+    }
+
+    [[nodiscard]] std::string_view function_name() const { return get_string_view(0); }
+
     void set(const std::size_t index, const variant& value)
     {
         if (index >= variants_.size()) {
@@ -0,0 +1,165 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <glm/glm.hpp>
+
+#include "packet_variant.hpp"
+
+namespace packet {
+using variant_view = std::variant<float, std::string_view, glm::vec2, glm::vec3, uint32_t, int32_t>;
+
+// Non-owning PacketVariant, deserialized into a fixed array of slots whose strings point into the
+// packet buffer. Nothing is allocated, so it is only valid while that buffer is alive, use
+// to_owned() to keep the arguments around. Calls with more than MAX_SIZE arguments do not fit,
+// deserialize() rejects them and callers fall back to an owning PacketVariant, see fits().
+class PacketVariantView {
+public:
+    static constexpr std::size_t MAX_SIZE{ 16 };
+
+    PacketVariantView()
+        : slots_{}
+        , size_{ 0 }
+    { }
+
+    // Whether the argument count of a serialized variant fits the slots
+    [[nodiscard]] static bool fits(const std::span<const std::byte> data)
+    {
+        return !data.empty() && std::to_integer<std::size_t>(data[0]) <= MAX_SIZE;
+    }
+
+    [[nodiscard]] bool deserialize(const std::span<const std::byte> data)
+    {
+        size_ = 0;
+
+        std::size_t offset{ 0 };
+        const auto read = [&]<typename T>(T& value) {
+            if (data.size() - offset < sizeof(T)) {
+                return false;
+            }
+
+            std::memcpy(&value, data.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        };
+
+        uint8_t size{ 0 };
+        if (!read(size) || size == 0 || size > MAX_SIZE) {
+            return false;
+        }
+
+        for (uint8_t i{ 0 }; i < size; i++) {
+            uint8_t index{ 0 };
+            uint8_t type{ 0 };
+            if (!read(index) || !read(type)) {
+                return false;
+            }
+
+            auto& slot{ slots_[size_] };
+            bool ok{ false };
+
+            switch (static_cast<VariantType>(type)) {
+            case VariantType::FLOAT: {
+                float value{ 0.0f };
+                ok = read(value);
+                slot = value;
+                break;
+            }
+            case VariantType::STRING: {
+                uint32_t length{ 0 };
+                ok = read(length) && length <= data.size() - offset;
+                if (ok) {
+                    slot = std::string_view{ reinterpret_cast<const char*>(data.data() + offset), length };
+                    offset += length;
+                }
+                break;
+            }
+            case VariantType::VEC2: {
+                glm::vec2 value{};
+                ok = read(value.x) && read(value.y);
+                slot = value;
+                break;
+            }
+            case VariantType::VEC3: {
+                glm::vec3 value{};
+                ok = read(value.x) && read(value.y) && read(value.z);
+                slot = value;
+                break;
+            }
+            case VariantType::UNSIGNED: {
+                uint32_t value{ 0 };
+                ok = read(value);
+                slot = value;
+                break;
+            }
+            case VariantType::SIGNED: {
+                int32_t value{ 0 };
+                ok = read(value);
+                slot = value;
+                break;
+            }
+            default:
+                // PacketVariant::deserialize skips unknown types without consuming a value
+                continue;
+            }
+
+            if (!ok) {
+                return false;
+            }
+
+            ++size_;
+        }
+
+        return true;
+    }
+
+    template <typename T = std::string_view>
+    [[nodiscard]] T get(const std::size_t index) const
+    {
+        if (index >= size_) {
+            return T{};
+        }
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            const auto* value{ std::get_if<std::string_view>(&slots_[index]) };
+            return value ? std::string{ *value } : std::string{};
+        }
+        else {
+            const auto* value{ std::get_if<T>(&slots_[index]) };
+            return value ? *value : T{};
+        }
+    }
+
+    [[nodiscard]] std::string_view function_name() const { return get<std::string_view>(0); }
+
+    [[nodiscard]] PacketVariant to_owned() const
+    {
+        PacketVariant variant{};
+        for (const auto& slot : slots()) {
+            std::visit([&variant]<typename T>(const T& value) {
+                if constexpr (std::is_same_v<T, std::string_view>) {
+                    variant.add(std::string{ value });
+                }
+                else {
+                    variant.add(value);
+                }
+            }, slot);
+        }
+
+        return variant;
+    }
+
+    [[nodiscard]] std::span<const variant_view> slots() const { return { slots_.data(), size_ }; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+
+private:
+    std::array<variant_view, MAX_SIZE> slots_;
+    std::size_t size_;
+};
+}
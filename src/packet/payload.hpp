@@ -1,4 +1,5 @@
 #pragma once
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -6,7 +7,10 @@
 
 #include "packet_types.hpp"
 #include "packet_variant.hpp"
+#include "packet_variant_view.hpp"
+#include "../utils/shared_bytes.hpp"
 #include "../utils/text_parse.hpp"
+#include "../utils/text_parse_view.hpp"
 
 namespace packet {
 enum class PayloadType : uint8_t {
@@ -19,7 +23,9 @@ enum class PayloadType : uint8_t {
 struct TextPayload {
     NetMessageType message_type;
     utils::TextParse data;
-    std::vector<std::byte> raw_data; // Original raw bytes for pass-through
+    // Decoded payloads leave data empty and parse raw_data in place, valid as long as raw_data is
+    utils::TextParseView view;
+    utils::SharedBytes raw_data; // Original raw bytes for pass-through
 
     explicit TextPayload(NetMessageType type = NET_MESSAGE_GAME_MESSAGE)
         : message_type{ type }
@@ -39,14 +45,45 @@ struct TextPayload {
     TextPayload(const NetMessageType type, utils::TextParse parser, std::span<const std::byte> raw)
         : message_type{ type }
         , data{ std::move(parser) }
-        , raw_data{ raw.begin(), raw.end() }
+        , raw_data{ utils::SharedBytes::copy_of(raw) }
     { }
+
+    TextPayload(const NetMessageType type, utils::TextParse parser, utils::SharedBytes raw)
+        : message_type{ type }
+        , data{ std::move(parser) }
+        , raw_data{ std::move(raw) }
+    { }
+
+    TextPayload(const NetMessageType type, utils::TextParseView parsed, utils::SharedBytes raw)
+        : message_type{ type }
+        , view{ std::move(parsed) }
+        , raw_data{ std::move(raw) }
+    { }
+
+    template <typename T = std::string>
+    [[nodiscard]] T get(const std::string& key, const int index = 0) const
+    {
+        return view.empty() ? data.get<T>(key, index) : view.get<T>(key, index);
+    }
+
+    // Text of a received message in place, after the message type and without the null terminator
+    [[nodiscard]] static std::string_view message_of(const std::span<const std::byte> raw)
+    {
+        if (raw.size() <= sizeof(NetMessageType)) {
+            return {};
+        }
+
+        return {
+            reinterpret_cast<const char*>(raw.data()) + sizeof(NetMessageType),
+            raw.size() - sizeof(NetMessageType) - 1
+        };
+    }
 };
 
 struct GamePayload {
     GameUpdatePacket packet;
-    std::vector<std::byte> extra;
-    std::vector<std::byte> raw_data;
+    utils::SharedBytes extra;
+    utils::SharedBytes raw_data;
 
     GamePayload()
         : packet{}
@@ -54,7 +91,12 @@ struct GamePayload {
 
     GamePayload(const GameUpdatePacket& pkt, const std::vector<std::byte>& ext)
         : packet{ pkt }
-        , extra{ ext }
+        , extra{ utils::SharedBytes::copy_of(ext) }
+    { }
+
+    GamePayload(const GameUpdatePacket& pkt, utils::SharedBytes ext)
+        : packet{ pkt }
+        , extra{ std::move(ext) }
     { }
 
     GamePayload(const GameUpdatePacket& pkt, std::vector<std::byte> ext, std::vector<std::byte> raw)
@@ -65,15 +107,24 @@ struct GamePayload {
 
     GamePayload(const GameUpdatePacket& pkt, std::span<const std::byte> ext, std::span<const std::byte> raw)
         : packet{ pkt }
-        , extra{ ext.begin(), ext.end() }
-        , raw_data{ raw.begin(), raw.end() }
+        , extra{ utils::SharedBytes::copy_of(ext) }
+        , raw_data{ utils::SharedBytes::copy_of(raw) }
+    { }
+
+    // Both views share the received buffer, extra is normally a subspan of raw
+    GamePayload(const GameUpdatePacket& pkt, utils::SharedBytes ext, utils::SharedBytes raw)
+        : packet{ pkt }
+        , extra{ std::move(ext) }
+        , raw_data{ std::move(raw) }
     { }
 };
 
 struct VariantPayload {
     GameUpdatePacket game_packet;
     PacketVariant variant;
-    std::vector<std::byte> raw_data;
+    // Decoded payloads leave variant empty and point into raw_data, valid as long as raw_data is
+    PacketVariantView view;
+    utils::SharedBytes raw_data;
 
     explicit VariantPayload(PacketVariant var)
         : game_packet{}
@@ -98,12 +149,40 @@ struct VariantPayload {
     VariantPayload(const GameUpdatePacket& pkt, PacketVariant var, std::span<const std::byte> raw)
         : game_packet{ pkt }
         , variant{ std::move(var) }
-        , raw_data{ raw.begin(), raw.end() }
+        , raw_data{ utils::SharedBytes::copy_of(raw) }
     { }
 
-    [[nodiscard]] std::string function_name() const
+    VariantPayload(const GameUpdatePacket& pkt, PacketVariant var, utils::SharedBytes raw)
+        : game_packet{ pkt }
+        , variant{ std::move(var) }
+        , raw_data{ std::move(raw) }
+    { }
+
+    VariantPayload(const GameUpdatePacket& pkt, const PacketVariantView& var, utils::SharedBytes raw)
+        : game_packet{ pkt }
+        , view{ var }
+        , raw_data{ std::move(raw) }
+    { }
+
+    [[nodiscard]] std::string_view function_name() const
+    {
+        return view.empty() ? variant.function_name() : view.function_name();
+    }
+
+    [[nodiscard]] std::string_view get_string_view(const std::size_t index) const
+    {
+        return view.empty() ? variant.get_string_view(index) : view.get<std::string_view>(index);
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return view.empty() ? variant.size() : view.size();
+    }
+
+    // Owning copy for packets that keep or modify the arguments.
+    [[nodiscard]] PacketVariant to_variant() const
     {
-        return variant.get<std::string>(0);
+        return view.empty() ? variant : view.to_owned();
     }
 };
 
@@ -77,8 +77,15 @@ void CommandBindings::bind(sol::state& lua)
         return commands;
     });
 
-    cmd_table.set_function("execute", [this](const std::string& input) -> bool {
-        return handler_.registry().execute(input, server_, client_, dispatcher_, scheduler_);
+    // Runs for the named session, otherwise for the one of the event or timer being run
+    cmd_table.set_function("execute", [this](const std::string& input, const sol::optional<std::uint32_t> session_id) -> bool {
+        const auto session{ session_id ? worker_.find_session(*session_id) : worker_.active_session() };
+        if (!session) {
+            spdlog::error("[Lua] command.execute: no session to run '{}' for, pass a session id", input);
+            return false;
+        }
+
+        return handler_.registry().execute(input, *session, dispatcher_, scheduler_);
     });
 
     cmd_table.set_function("get_prefix", [this]() {
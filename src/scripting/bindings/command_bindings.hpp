@@ -7,22 +7,20 @@
 #include "../../command/command_handler.hpp"
 #include "../../core/scheduler.hpp"
 #include "../../event/event.hpp"
-#include "../../network/client.hpp"
-#include "../../network/server.hpp"
+#include "../../network/session.hpp"
+#include "../../network/session_worker.hpp"
 
 namespace scripting::bindings {
 class CommandBindings final : public IBindingModule {
  public:
     explicit CommandBindings(
         command::CommandHandler& handler,
-        network::Server& server,
-        network::Client& client,
+        network::ISessionWorker& worker,
         event::Dispatcher& dispatcher,
         std::shared_ptr<core::Scheduler> scheduler
     )
         : handler_{ handler }
-        , server_{ server }
-        , client_{ client }
+        , worker_{ worker }
         , dispatcher_{ dispatcher }
         , scheduler_{ std::move(scheduler) }
     {
@@ -35,8 +33,7 @@ class CommandBindings final : public IBindingModule {
 
  private:
     command::CommandHandler& handler_;
-    network::Server& server_;
-    network::Client& client_;
+    network::ISessionWorker& worker_;
     event::Dispatcher& dispatcher_;
     std::shared_ptr<core::Scheduler> scheduler_;
 };
@@ -1,5 +1,6 @@
 #include "item_bindings.hpp"
 
+#include <optional>
 #include <magic_enum/magic_enum.hpp>
 #include <sol/sol.hpp>
 
@@ -14,8 +15,13 @@ void ItemBindings::bind_item_database(sol::state& lua)
         "get_version", &item::ItemDatabase::get_version,
         "get_count", &item::ItemDatabase::get_count,
         "empty", &item::ItemDatabase::empty,
-        "get_item", [](const item::ItemDatabase& db, std::uint32_t id) -> const item::ItemInfo* {
-            return db.get_item(id);
+        // A copy, the database may move on to a newer items.dat while the script holds it
+        "get_item", [](const item::ItemDatabase& db, std::uint32_t id) -> std::optional<item::ItemInfo> {
+            if (const auto info{ db.get_item(id) }) {
+                return *info;
+            }
+
+            return std::nullopt;
         }
     );
 
@@ -8,6 +8,7 @@ namespace scripting::bindings {
 void PacketBindings::bind(sol::state& lua)
 {
     bind_enums(lua);
+    bind_bytes(lua);
     bind_text_parse(lua);
     bind_base_packet(lua);
     bind_message_packets(lua);
@@ -55,6 +56,66 @@ void PacketBindings::bind_enums(sol::state& lua)
     lua["packet"] = packet_table;
 }
 
+void PacketBindings::bind_bytes(sol::state& lua)
+{
+    // Offsets are 0 based, except b[i] which stays 1 based like the byte tables next to it
+    lua.new_usertype<utils::ByteBuffer>("Bytes",
+        sol::no_constructor,
+        "new", [](const std::size_t size) { return utils::ByteBuffer::zeroed(size); },
+        "from_string", [](const std::string_view str) { return utils::ByteBuffer::from_string(str); },
+
+        "size", &utils::ByteBuffer::size,
+        sol::meta_function::length, &utils::ByteBuffer::size,
+        sol::meta_function::index, [](const utils::ByteBuffer& b, const std::size_t index) {
+            return index > 0 ? b.read<uint8_t>(index - 1) : std::nullopt;
+        },
+
+        "u8", &utils::ByteBuffer::read<uint8_t>,
+        "u16", &utils::ByteBuffer::read<uint16_t>,
+        "u32", &utils::ByteBuffer::read<uint32_t>,
+        "i32", &utils::ByteBuffer::read<int32_t>,
+        "f32", &utils::ByteBuffer::read<float>,
+        "str", &utils::ByteBuffer::str,
+
+        "set_u8", &utils::ByteBuffer::write<uint8_t>,
+        "set_u16", &utils::ByteBuffer::write<uint16_t>,
+        "set_u32", &utils::ByteBuffer::write<uint32_t>,
+        "set_i32", &utils::ByteBuffer::write<int32_t>,
+        "set_f32", &utils::ByteBuffer::write<float>,
+        "patch", sol::overload(
+            [](utils::ByteBuffer& b, const std::size_t offset, const utils::ByteBuffer& data) {
+                return b.patch(offset, data.span());
+            },
+            [](utils::ByteBuffer& b, const std::size_t offset, const std::string_view data) {
+                return b.patch(offset, std::as_bytes(std::span{ data }));
+            }
+        ),
+
+        "slice", sol::overload(
+            [](const utils::ByteBuffer& b, const std::size_t offset) { return b.slice(offset); },
+            [](const utils::ByteBuffer& b, const std::size_t offset, const std::size_t count) {
+                return b.slice(offset, count);
+            }
+        ),
+        "to_string", &utils::ByteBuffer::to_string,
+        "to_table", [](const utils::ByteBuffer& b, sol::this_state s) { return to_table(s, b.span()); }
+    );
+}
+
+utils::ByteBuffer PacketBindings::to_bytes(const std::span<const std::byte> data)
+{
+    return utils::ByteBuffer{ utils::SharedBytes::copy_of(data) };
+}
+
+sol::table PacketBindings::to_table(sol::state_view lua, const std::span<const std::byte> data)
+{
+    sol::table t = lua.create_table(static_cast<int>(data.size()));
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        t[i + 1] = static_cast<uint8_t>(data[i]);
+    }
+    return t;
+}
+
 void PacketBindings::bind_text_parse(sol::state& lua)
 {
     lua.new_usertype<utils::TextParse>("utils::TextParse",
@@ -104,13 +165,9 @@ void PacketBindings::bind_base_packet(sol::state& lua)
         "channel", &packet::IPacket::channel,
         "has_raw_data", &packet::IPacket::has_raw_data,
         "raw", sol::property([](const packet::IPacket& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.raw_data.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.raw_data[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.raw_data);
+        }),
+        "raw_bytes", sol::property([](const packet::IPacket& p) { return to_bytes(p.raw_data); })
     );
 }
 
@@ -119,26 +176,26 @@ void PacketBindings::bind_message_packets(sol::state& lua)
     lua.new_usertype<packet::message::ServerHello>("ServerHelloPacket",
         sol::constructors<packet::message::ServerHello()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "text_parse", &packet::message::ServerHello::text_parse
+        "text_parse", sol::property([](packet::message::ServerHello& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::Log>("LogPacket",
         sol::constructors<packet::message::Log()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "msg", &packet::message::Log::msg,
-        "text_parse", &packet::message::Log::text_parse
+        "text_parse", sol::property([](packet::message::Log& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::Quit>("QuitPacket",
         sol::constructors<packet::message::Quit()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "text_parse", &packet::message::Quit::text_parse
+        "text_parse", sol::property([](packet::message::Quit& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::QuitToExit>("QuitToExitPacket",
         sol::constructors<packet::message::QuitToExit()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "text_parse", &packet::message::QuitToExit::text_parse
+        "text_parse", sol::property([](packet::message::QuitToExit& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::JoinRequest>("JoinRequestPacket",
@@ -146,21 +203,21 @@ void PacketBindings::bind_message_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "world_name", &packet::message::JoinRequest::world_name,
         "invited_world", &packet::message::JoinRequest::invited_world,
-        "text_parse", &packet::message::JoinRequest::text_parse
+        "text_parse", sol::property([](packet::message::JoinRequest& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::ValidateWorld>("ValidateWorldPacket",
         sol::constructors<packet::message::ValidateWorld()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "world_name", &packet::message::ValidateWorld::world_name,
-        "text_parse", &packet::message::ValidateWorld::text_parse
+        "text_parse", sol::property([](packet::message::ValidateWorld& p) -> utils::TextParse& { return p.text_parse(); })
     );
 
     lua.new_usertype<packet::message::Input>("InputPacket",
         sol::constructors<packet::message::Input()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "text", &packet::message::Input::text,
-        "text_parse", &packet::message::Input::text_parse
+        "text_parse", sol::property([](packet::message::Input& p) -> utils::TextParse& { return p.text_parse(); })
     );
 }
 
@@ -171,13 +228,9 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "game_packet", &packet::game::Disconnect::game_packet,
         "extra", sol::property([](const packet::game::Disconnect& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.extra.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.extra[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.extra);
+        }),
+        "extra_bytes", sol::property([](const packet::game::Disconnect& p) { return to_bytes(p.extra); })
     );
 
     lua.new_usertype<packet::game::OnSendToServer>("OnSendToServerPacket",
@@ -191,7 +244,7 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         "uuid_token", &packet::game::OnSendToServer::uuid_token,
         "login_mode", &packet::game::OnSendToServer::login_mode,
         "username", &packet::game::OnSendToServer::username,
-        "variant", &packet::game::OnSendToServer::variant,
+        "variant", sol::property([](packet::game::OnSendToServer& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::game::OnSendToServer::game_packet
     );
 
@@ -200,7 +253,7 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "name", &packet::game::OnNameChanged::name,
         "net_id", &packet::game::OnNameChanged::net_id,
-        "variant", &packet::game::OnNameChanged::variant,
+        "variant", sol::property([](packet::game::OnNameChanged& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::game::OnNameChanged::game_packet
     );
 
@@ -209,7 +262,7 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "skin", &packet::game::OnChangeSkin::skin_code,
         "net_id", &packet::game::OnChangeSkin::net_id,
-        "variant", &packet::game::OnChangeSkin::variant,
+        "variant", sol::property([](packet::game::OnChangeSkin& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::game::OnChangeSkin::game_packet
     );
 
@@ -234,7 +287,7 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         "online_id", &packet::game::OnSpawn::online_id,
         "type", &packet::game::OnSpawn::type,
         "title_icon", &packet::game::OnSpawn::title_icon,
-        "variant", &packet::game::OnSpawn::variant,
+        "variant", sol::property([](packet::game::OnSpawn& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::game::OnSpawn::game_packet
     );
 
@@ -243,7 +296,7 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "net_id", &packet::game::OnRemove::net_id,
         "player_id", &packet::game::OnRemove::player_id,
-        "variant", &packet::game::OnRemove::variant,
+        "variant", sol::property([](packet::game::OnRemove& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::game::OnRemove::game_packet
     );
 
@@ -251,26 +304,18 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::constructors<packet::game::SendMapData()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "extra", sol::property([](const packet::game::SendMapData& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.extra.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.extra[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.extra);
+        }),
+        "extra_bytes", sol::property([](const packet::game::SendMapData& p) { return to_bytes(p.extra); })
     );
 
     lua.new_usertype<packet::game::SendTileUpdateData>("SendTileUpdateDataPacket",
         sol::constructors<packet::game::SendTileUpdateData()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "extra", sol::property([](const packet::game::SendTileUpdateData& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.extra.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.extra[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.extra);
+        }),
+        "extra_bytes", sol::property([](const packet::game::SendTileUpdateData& p) { return to_bytes(p.extra); })
     );
 
     lua.new_usertype<packet::game::TileChangeRequest>("TileChangeRequestPacket",
@@ -293,7 +338,9 @@ void PacketBindings::bind_game_packets(sol::state& lua)
     lua.new_usertype<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a>("OnSuperMainStartAcceptLogonPacket",
         sol::constructors<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "variant", &packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a::variant,
+        "variant", sol::property([](packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a& p) -> packet::PacketVariant& {
+            return p.variant();
+        }),
         "game_packet", &packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a::game_packet,
         "item_hash", &packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a::item_hash,
         "u", &packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a::u,
@@ -306,13 +353,9 @@ void PacketBindings::bind_game_packets(sol::state& lua)
         sol::constructors<packet::game::SendInventoryState()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
         "extra", sol::property([](const packet::game::SendInventoryState& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.extra.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.extra[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.extra);
+        }),
+        "extra_bytes", sol::property([](const packet::game::SendInventoryState& p) { return to_bytes(p.extra); })
     );
 
     lua.new_usertype<packet::game::ModifyItemInventory>("ModifyItemInventoryPacket",
@@ -329,14 +372,14 @@ void PacketBindings::bind_generic_packets(sol::state& lua)
     lua.new_usertype<packet::GenericTextPacket>("GenericTextPacket",
         sol::constructors<packet::GenericTextPacket()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "text_parse", &packet::GenericTextPacket::text_parse,
+        "text_parse", sol::property([](packet::GenericTextPacket& p) -> utils::TextParse& { return p.text_parse(); }),
         "message_type", &packet::GenericTextPacket::message_type
     );
 
     lua.new_usertype<packet::GenericVariantPacket>("GenericVariantPacket",
         sol::constructors<packet::GenericVariantPacket()>(),
         sol::base_classes, sol::bases<packet::IPacket>(),
-        "variant", &packet::GenericVariantPacket::variant,
+        "variant", sol::property([](packet::GenericVariantPacket& p) -> packet::PacketVariant& { return p.variant(); }),
         "game_packet", &packet::GenericVariantPacket::game_packet
     );
 
@@ -345,13 +388,9 @@ void PacketBindings::bind_generic_packets(sol::state& lua)
         sol::base_classes, sol::bases<packet::IPacket>(),
         "game_packet", &packet::GenericGamePacket::game_packet,
         "extra", sol::property([](const packet::GenericGamePacket& p, sol::this_state s) {
-            sol::state_view lua{ s };
-            sol::table t = lua.create_table();
-            for (std::size_t i = 0; i < p.extra.size(); ++i) {
-                t[i + 1] = static_cast<uint8_t>(p.extra[i]);
-            }
-            return t;
-        })
+            return to_table(s, p.extra);
+        }),
+        "extra_bytes", sol::property([](const packet::GenericGamePacket& p) { return to_bytes(p.extra); })
     );
 }
 
@@ -491,21 +530,50 @@ void PacketBindings::bind_send_functions(sol::state& lua)
 {
     auto send_table{ lua.create_table() };
 
-    send_table.set_function("to_server", [this](packet::IPacket& pkt) {
-        spdlog::debug("[Lua] Sending packet to server");
-        return packet::PacketHelper::write(pkt, client_);
+    // Every send takes an optional session id, without one it goes to the session of the event or
+    // timer being run. Timers scheduled at load time and other callbacks have to pass one.
+    send_table.set_function("to_server", [this](packet::IPacket& pkt, const sol::optional<std::uint32_t> session_id) {
+        const auto session{ resolve_session("send.to_server", session_id) };
+        if (!session) {
+            return false;
+        }
+
+        spdlog::debug("[Lua] Sending packet to server (session {})", session->id());
+        return packet::PacketHelper::write(pkt, session->upstream());
     });
 
-    send_table.set_function("to_client", [this](packet::IPacket& pkt) {
-        spdlog::debug("[Lua] Sending packet to client");
-        return packet::PacketHelper::write(pkt, server_);
+    send_table.set_function("to_client", [this](packet::IPacket& pkt, const sol::optional<std::uint32_t> session_id) {
+        const auto session{ resolve_session("send.to_client", session_id) };
+        if (!session) {
+            return false;
+        }
+
+        spdlog::debug("[Lua] Sending packet to client (session {})", session->id());
+        return packet::PacketHelper::write(pkt, session->downstream());
     });
 
     lua["send"] = send_table;
 
     auto packet_table{ lua["packet"].get_or(lua.create_table()) };
 
-    packet_table.set_function("send_raw", [this](const sol::table& data_table, const bool to_server) {
+    const auto send_raw_bytes{ [this](
+        const utils::ByteBuffer& data,
+        const bool to_server,
+        const sol::optional<std::uint32_t> session_id
+    ) {
+        if (data.empty()) {
+            spdlog::warn("[Lua] send_raw: empty data");
+            return false;
+        }
+
+        return send_to_direction(data.span(), to_server, session_id);
+    } };
+
+    const auto send_raw_table{ [this](
+        const sol::table& data_table,
+        const bool to_server,
+        const sol::optional<std::uint32_t> session_id
+    ) {
         std::vector<std::byte> data;
         data.reserve(data_table.size());
 
@@ -521,23 +589,41 @@ void PacketBindings::bind_send_functions(sol::state& lua)
             return false;
         }
 
-        return send_to_direction(data, to_server);
-    });
+        return send_to_direction(data, to_server, session_id);
+    } };
+
+    // sol picks overloads by argument count, the session id gets its own entries
+    packet_table.set_function("send_raw", sol::overload(
+        [send_raw_bytes](const utils::ByteBuffer& data, const bool to_server) {
+            return send_raw_bytes(data, to_server, sol::optional<std::uint32_t>{});
+        },
+        [send_raw_bytes](const utils::ByteBuffer& data, const bool to_server, const std::uint32_t session_id) {
+            return send_raw_bytes(data, to_server, session_id);
+        },
+        [send_raw_table](const sol::table& data_table, const bool to_server) {
+            return send_raw_table(data_table, to_server, sol::optional<std::uint32_t>{});
+        },
+        [send_raw_table](const sol::table& data_table, const bool to_server, const std::uint32_t session_id) {
+            return send_raw_table(data_table, to_server, session_id);
+        }
+    ));
 
     packet_table.set_function("send_text", [this](
         const std::string& text,
         const bool to_server,
-        const sol::optional<int> msg_type_opt
+        const sol::optional<int> msg_type_opt,
+        const sol::optional<std::uint32_t> session_id
     ) {
-        return send_text_packet(text, to_server, msg_type_opt);
+        return send_text_packet(text, to_server, msg_type_opt, session_id);
     });
 
     packet_table.set_function("send_text_parse", [this](
         const utils::TextParse& text_parse,
         const bool to_server,
-        const sol::optional<int> msg_type_opt
+        const sol::optional<int> msg_type_opt,
+        const sol::optional<std::uint32_t> session_id
     ) {
-        return send_text_packet(text_parse.get_raw(), to_server, msg_type_opt);
+        return send_text_packet(text_parse.get_raw(), to_server, msg_type_opt, session_id);
     });
 
     packet_table["NET_MESSAGE_GENERIC_TEXT"] = static_cast<int>(packet::NET_MESSAGE_GENERIC_TEXT);
@@ -547,19 +633,49 @@ void PacketBindings::bind_send_functions(sol::state& lua)
     lua["packet"] = packet_table;
 }
 
-bool PacketBindings::send_to_direction(const std::vector<std::byte>& data, const bool to_server)
-{
+std::shared_ptr<network::Session> PacketBindings::resolve_session(
+    const std::string_view caller,
+    const sol::optional<std::uint32_t> session_id
+) const {
+    if (session_id) {
+        auto session{ worker_.find_session(*session_id) };
+        if (!session) {
+            spdlog::error("[Lua] {}: session {} is not open on this shard", caller, *session_id);
+        }
+
+        return session;
+    }
+
+    auto session{ worker_.active_session() };
+    if (!session) {
+        spdlog::error("[Lua] {}: no event or session timer is running, pass a session id", caller);
+    }
+
+    return session;
+}
+
+bool PacketBindings::send_to_direction(
+    const std::span<const std::byte> data,
+    const bool to_server,
+    const sol::optional<std::uint32_t> session_id
+) {
+    const auto session{ resolve_session("packet.send", session_id) };
+    if (!session) {
+        return false;
+    }
+
     if (to_server) {
-        return client_.write(data);
+        return session->upstream().write(data);
     }
 
-    return server_.write(data);
+    return session->downstream().write(data);
 }
 
 bool PacketBindings::send_text_packet(
     const std::string& text,
     const bool to_server,
-    const sol::optional<int> msg_type_opt
+    const sol::optional<int> msg_type_opt,
+    const sol::optional<std::uint32_t> session_id
 )
 {
     const packet::NetMessageType msg_type = msg_type_opt.has_value()
@@ -573,6 +689,6 @@ bool PacketBindings::send_text_packet(
     auto data = stream.get_data();
     data.push_back(static_cast<std::byte>(0x00));
 
-    return send_to_direction(data, to_server);
+    return send_to_direction(data, to_server, session_id);
 }
 }
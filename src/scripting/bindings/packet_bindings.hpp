@@ -1,7 +1,7 @@
 #pragma once
 #include "../binding_module.hpp"
-#include "../../network/client.hpp"
-#include "../../network/server.hpp"
+#include "../../network/session.hpp"
+#include "../../network/session_worker.hpp"
 #include "../../packet/packet_helper.hpp"
 #include "../../packet/generic_packets.hpp"
 #include "../../packet/message/chat.hpp"
@@ -12,6 +12,7 @@
 #include "../../packet/game/player.hpp"
 #include "../../packet/game/world.hpp"
 #include "../../packet/packet_variant.hpp"
+#include "../../utils/byte_buffer.hpp"
 #include "../../utils/text_parse.hpp"
 #include "../../packet/packet_types.hpp"
 
@@ -21,9 +22,8 @@
 namespace scripting::bindings {
 class PacketBindings final : public IBindingModule {
 public:
-    explicit PacketBindings(network::Client& client, network::Server& server)
-        : client_{ client }
-        , server_{ server }
+    explicit PacketBindings(network::ISessionWorker& worker)
+        : worker_{ worker }
     {
     }
 
@@ -31,8 +31,15 @@ public:
 
     void bind(sol::state& lua) override;
 
+    // One entry per byte, 1 based, what raw, extra and get_data return
+    [[nodiscard]] static sol::table to_table(sol::state_view lua, std::span<const std::byte> data);
+
+    // Copied, a Bytes kept by a script must not hold on to the received packet
+    [[nodiscard]] static utils::ByteBuffer to_bytes(std::span<const std::byte> data);
+
 private:
     void bind_enums(sol::state& lua);
+    void bind_bytes(sol::state& lua);
     void bind_text_parse(sol::state& lua);
     void bind_base_packet(sol::state& lua);
     void bind_message_packets(sol::state& lua);
@@ -41,14 +48,25 @@ private:
     void bind_game_update_packet(sol::state& lua);
     void bind_packet_variant(sol::state& lua);
     void bind_send_functions(sol::state& lua);
-    bool send_to_direction(const std::vector<std::byte>& data, const bool to_server);
+
+    // The named session, otherwise the active one. Logs and returns null if there is none.
+    [[nodiscard]] std::shared_ptr<network::Session> resolve_session(
+        std::string_view caller,
+        sol::optional<std::uint32_t> session_id
+    ) const;
+
+    bool send_to_direction(
+        const std::span<const std::byte> data,
+        const bool to_server,
+        const sol::optional<std::uint32_t> session_id
+    );
     bool send_text_packet(
         const std::string& text,
         const bool to_server,
-        const sol::optional<int> msg_type_opt
+        const sol::optional<int> msg_type_opt,
+        const sol::optional<std::uint32_t> session_id
     );
 
-    network::Client& client_;
-    network::Server& server_;
+    network::ISessionWorker& worker_;
 };
 }
@@ -1,5 +1,10 @@
 #include "scheduler_bindings.hpp"
 
+#include <magic_enum/magic_enum.hpp>
+#include <spdlog/spdlog.h>
+
+#include "../../network/session.hpp"
+
 namespace scripting::bindings {
 void SchedulerBindings::bind(sol::state& lua)
 {
@@ -9,13 +14,15 @@ void SchedulerBindings::bind(sol::state& lua)
         [this](const int delay_ms, sol::protected_function callback) {
                 return scheduler_.schedule(
                     std::chrono::milliseconds{ delay_ms },
-                    std::move(callback)
+                    std::move(callback),
+                    current_session()
                 );
             },
             [this](const double delay_ms, sol::protected_function callback) {
                 return scheduler_.schedule(
                     std::chrono::milliseconds{ static_cast<int>(delay_ms) },
-                    std::move(callback)
+                    std::move(callback),
+                    current_session()
                 );
             }
     ));
@@ -24,27 +31,56 @@ void SchedulerBindings::bind(sol::state& lua)
         [this](const int interval_ms, sol::protected_function callback) {
                 return scheduler_.schedule_periodic(
                     std::chrono::milliseconds{ interval_ms },
-                    std::move(callback)
+                    std::move(callback),
+                    std::chrono::milliseconds{ 0 },
+                    CatchUp::Skip,
+                    current_session()
                 );
             },
             [this](const int interval_ms, sol::protected_function callback, const int initial_delay_ms) {
                 return scheduler_.schedule_periodic(
                     std::chrono::milliseconds{ interval_ms },
                     std::move(callback),
-                    std::chrono::milliseconds{ initial_delay_ms }
+                    std::chrono::milliseconds{ initial_delay_ms },
+                    CatchUp::Skip,
+                    current_session()
                 );
             },
             [this](const double interval_ms, sol::protected_function callback) {
                 return scheduler_.schedule_periodic(
                     std::chrono::milliseconds{ static_cast<int>(interval_ms) },
-                    std::move(callback)
+                    std::move(callback),
+                    std::chrono::milliseconds{ 0 },
+                    CatchUp::Skip,
+                    current_session()
                 );
             },
             [this](const double interval_ms, sol::protected_function callback, const double initial_delay_ms) {
                 return scheduler_.schedule_periodic(
                     std::chrono::milliseconds{ static_cast<int>(interval_ms) },
                     std::move(callback),
-                    std::chrono::milliseconds{ static_cast<int>(initial_delay_ms) }
+                    std::chrono::milliseconds{ static_cast<int>(initial_delay_ms) },
+                    CatchUp::Skip,
+                    current_session()
+                );
+            },
+            [this](
+                const double interval_ms,
+                sol::protected_function callback,
+                const double initial_delay_ms,
+                const std::string& catch_up
+            ) {
+                const auto policy{ magic_enum::enum_cast<CatchUp>(catch_up, magic_enum::case_insensitive) };
+                if (!policy) {
+                    spdlog::warn("[Lua] scheduler.schedule_periodic: unknown catch-up policy '{}', using Skip", catch_up);
+                }
+
+                return scheduler_.schedule_periodic(
+                    std::chrono::milliseconds{ static_cast<int>(interval_ms) },
+                    std::move(callback),
+                    std::chrono::milliseconds{ static_cast<int>(initial_delay_ms) },
+                    policy.value_or(CatchUp::Skip),
+                    current_session()
                 );
             }
     ));
@@ -67,4 +103,11 @@ void SchedulerBindings::bind(sol::state& lua)
 
     lua["scheduler"] = scheduler_table;
 }
+
+SessionId SchedulerBindings::current_session() const
+{
+    // Timers scheduled from a timer keep its session, ones scheduled at load time have none
+    const auto session{ worker_.active_session() };
+    return session ? session->id() : NO_SESSION;
+}
 }
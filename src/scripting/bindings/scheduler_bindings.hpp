@@ -3,12 +3,14 @@
 
 #include "../binding_module.hpp"
 #include "../script_scheduler.hpp"
+#include "../../network/session_worker.hpp"
 
 namespace scripting::bindings {
 class SchedulerBindings final : public IBindingModule {
 public:
-    explicit SchedulerBindings(ScriptScheduler& scheduler)
+    SchedulerBindings(ScriptScheduler& scheduler, network::ISessionWorker& worker)
         : scheduler_{ scheduler }
+        , worker_{ worker }
     {
 
     }
@@ -17,7 +19,12 @@ public:
 
     void bind(sol::state& lua) override;
 
+private:
+    // Captured when a timer is scheduled, its callback runs with that session active
+    [[nodiscard]] SessionId current_session() const;
+
 private:
     ScriptScheduler& scheduler_;
+    network::ISessionWorker& worker_;
 };
 }
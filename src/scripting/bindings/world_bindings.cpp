@@ -1,6 +1,43 @@
 #include "world_bindings.hpp"
 
+#include "../../network/session.hpp"
+
 namespace scripting::bindings {
+namespace {
+// The `world` global. One Lua state serves every session of its shard, so each call looks up the
+// world of the session being dispatched, or of the one whose timer is running, instead of holding
+// on to a single World. world:of(session_id) names the session explicitly.
+struct ActiveWorld {
+    network::ISessionWorker& worker;
+
+    [[nodiscard]] world::World* get() const
+    {
+        const auto session{ worker.active_session() };
+        return session ? &session->world() : nullptr;
+    }
+
+    [[nodiscard]] world::World* of(const std::uint32_t session_id) const
+    {
+        const auto session{ worker.find_session(session_id) };
+        return session ? &session->world() : nullptr;
+    }
+};
+
+sol::table players_table(const world::World* world, const sol::this_state& this_state)
+{
+    sol::state_view state{ this_state };
+    sol::table players{ state.create_table() };
+
+    if (world) {
+        for (const auto& [net_id, player] : world->get_players()) {
+            players[net_id] = player;
+        }
+    }
+
+    return players;
+}
+}
+
 void WorldBindings::bind(sol::state& lua)
 {
     lua.new_usertype<world::World>("World",
@@ -13,14 +50,7 @@ void WorldBindings::bind(sol::state& lua)
             return world.get_player(net_id).lock();
         },
         "get_players", [](const world::World& world, const sol::this_state& this_state) {
-            sol::state_view state{ this_state };
-            sol::table players{ state.create_table() };
-
-            for (const auto& [net_id, player] : world.get_players()) {
-                players[net_id] = player;
-            }
-
-            return players;
+            return players_table(&world, this_state);
         },
         "get_tile_map", [](world::World& world) -> WorldTileMap& {
             return world.get_tile_map();
@@ -31,6 +61,39 @@ void WorldBindings::bind(sol::state& lua)
         "get_version", &world::World::get_version
     );
 
-    lua["world"] = std::ref(world::World::instance());
+    // Same interface as World, without a session every getter comes back empty
+    lua.new_usertype<ActiveWorld>("ActiveWorld",
+        sol::no_constructor,
+        "of", &ActiveWorld::of,
+        "get_local_player", [](const ActiveWorld& active) -> std::shared_ptr<player::Player> {
+            const auto world{ active.get() };
+            return world ? world->get_local_player().lock() : nullptr;
+        },
+        "get_local_net_id", [](const ActiveWorld& active) -> int32_t {
+            const auto world{ active.get() };
+            return world ? world->get_local_net_id() : -1;
+        },
+        "get_player", [](const ActiveWorld& active, const int32_t net_id) -> std::shared_ptr<player::Player> {
+            const auto world{ active.get() };
+            return world ? world->get_player(net_id).lock() : nullptr;
+        },
+        "get_players", [](const ActiveWorld& active, const sol::this_state& this_state) {
+            return players_table(active.get(), this_state);
+        },
+        "get_tile_map", [](const ActiveWorld& active) -> WorldTileMap* {
+            const auto world{ active.get() };
+            return world ? &world->get_tile_map() : nullptr;
+        },
+        "get_object_map", [](const ActiveWorld& active) -> WorldObjectMap* {
+            const auto world{ active.get() };
+            return world ? &world->get_object_map() : nullptr;
+        },
+        "get_version", [](const ActiveWorld& active) -> uint16_t {
+            const auto world{ active.get() };
+            return world ? world->get_version() : 0;
+        }
+    );
+
+    lua["world"] = ActiveWorld{ worker_ };
 }
 }
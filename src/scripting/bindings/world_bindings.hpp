@@ -2,13 +2,22 @@
 #include <sol/sol.hpp>
 
 #include "../binding_module.hpp"
+#include "../../network/session_worker.hpp"
 #include "../../world/world.hpp"
 
 namespace scripting::bindings {
 class WorldBindings final : public IBindingModule {
 public:
+    explicit WorldBindings(network::ISessionWorker& worker)
+        : worker_{ worker }
+    {
+    }
+
     [[nodiscard]] std::string_view name() const override { return "world"; }
 
     void bind(sol::state& lua) override;
+
+private:
+    network::ISessionWorker& worker_;
 };
 }
@@ -0,0 +1,194 @@
+#include "bytecode_cache.hpp"
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "../utils/hash.hpp"
+
+namespace scripting {
+namespace {
+constexpr std::uint32_t FILE_MAGIC{ 0x43425447 }; // "GTBC"
+constexpr std::uint32_t FILE_VERSION{ 1 };
+
+// Followed by the script path and the bytecode
+struct FileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t size;
+    std::int64_t mtime;
+    std::uint64_t hash;
+    std::uint32_t path_length;
+};
+}
+
+void BytecodeCache::configure(const core::Config::ScriptConfig& config)
+{
+    std::scoped_lock lock{ mutex_ };
+    directory_ = config.bytecode_cache_on_disk
+        ? std::filesystem::path{ config.bytecode_cache_directory }
+        : std::filesystem::path{};
+}
+
+std::optional<BytecodeCache::Key> BytecodeCache::make_key(const std::filesystem::path& path, const std::string_view source)
+{
+    std::error_code ec{};
+    const auto absolute{ std::filesystem::absolute(path, ec) };
+    if (ec) {
+        return std::nullopt;
+    }
+
+    const auto mtime{ std::filesystem::last_write_time(path, ec) };
+    if (ec) {
+        return std::nullopt;
+    }
+
+    return Key{
+        absolute.lexically_normal().string(),
+        source.size(),
+        static_cast<std::int64_t>(mtime.time_since_epoch().count()),
+        utils::hash::fnv1a_64(source)
+    };
+}
+
+std::optional<std::string> BytecodeCache::find(const Key& key)
+{
+    std::scoped_lock lock{ mutex_ };
+
+    if (const auto it{ entries_.find(key.path) }; it != entries_.end()) {
+        if (it->second.key == key) {
+            return it->second.bytecode;
+        }
+
+        entries_.erase(it);
+    }
+
+    auto bytecode{ read_file(key) };
+    if (bytecode) {
+        entries_.insert_or_assign(key.path, Entry{ key, *bytecode });
+    }
+
+    return bytecode;
+}
+
+void BytecodeCache::store(const Key& key, std::string bytecode)
+{
+    write_file(key, bytecode);
+
+    std::scoped_lock lock{ mutex_ };
+    entries_.insert_or_assign(key.path, Entry{ key, std::move(bytecode) });
+}
+
+void BytecodeCache::invalidate(const Key& key)
+{
+    std::scoped_lock lock{ mutex_ };
+    entries_.erase(key.path);
+    if (directory_.empty()) {
+        return;
+    }
+
+    std::error_code ec{};
+    std::filesystem::remove(file_for(key.path), ec);
+}
+
+std::filesystem::path BytecodeCache::file_for(const std::string& path) const
+{
+    return directory_ / fmt::format("{:016x}.luac", utils::hash::fnv1a_64(path));
+}
+
+std::optional<std::string> BytecodeCache::read_file(const Key& key) const
+{
+    if (directory_.empty()) {
+        return std::nullopt;
+    }
+
+    std::ifstream in{ file_for(key.path), std::ios::binary };
+    if (!in) {
+        return std::nullopt;
+    }
+
+    FileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return std::nullopt;
+    }
+
+    if (
+        header.magic != FILE_MAGIC
+        || header.version != FILE_VERSION
+        || header.size != key.size
+        || header.mtime != key.mtime
+        || header.hash != key.hash
+        || header.path_length != key.path.size()
+    ) {
+        return std::nullopt;
+    }
+
+    // Two paths may hash to the same file name
+    std::string path(header.path_length, '\0');
+    if (!in.read(path.data(), static_cast<std::streamsize>(path.size())) || path != key.path) {
+        return std::nullopt;
+    }
+
+    std::string bytecode{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+    if (bytecode.empty()) {
+        return std::nullopt;
+    }
+
+    return bytecode;
+}
+
+void BytecodeCache::write_file(const Key& key, const std::string_view bytecode) const
+{
+    if (directory_.empty()) {
+        return;
+    }
+
+    std::error_code ec{};
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        spdlog::warn("Failed to create bytecode cache directory '{}': {}", directory_.string(), ec.message());
+        return;
+    }
+
+    const auto target{ file_for(key.path) };
+    // Written next to the target and renamed over it, other shards never read a partial file
+    auto temp{ target };
+    temp += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+    {
+        std::ofstream out{ temp, std::ios::binary | std::ios::trunc };
+        if (!out) {
+            spdlog::warn("Failed to write bytecode cache '{}'", temp.string());
+            return;
+        }
+
+        const FileHeader header{
+            FILE_MAGIC,
+            FILE_VERSION,
+            key.size,
+            key.mtime,
+            key.hash,
+            static_cast<std::uint32_t>(key.path.size())
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.path.data(), static_cast<std::streamsize>(key.path.size()));
+        out.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!out) {
+            spdlog::warn("Failed to write bytecode cache '{}'", temp.string());
+            out.close();
+            std::filesystem::remove(temp, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        spdlog::warn("Failed to replace bytecode cache '{}': {}", target.string(), ec.message());
+        std::filesystem::remove(temp, ec);
+    }
+}
+}
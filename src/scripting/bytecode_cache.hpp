@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "../core/config.hpp"
+#include "../utils/singleton.hpp"
+
+namespace scripting {
+// Compiled Lua chunks, kept in memory and optionally on disk so scripts are only compiled again
+// after they change. Shared by every shard's engine: the first one to load a script compiles it,
+// the others reuse its bytecode. Lua loads the cached chunks as binary without verifying them, so
+// the on-disk cache is off unless configured and its directory has to be as trusted as the scripts.
+class BytecodeCache : public utils::Singleton<BytecodeCache> {
+public:
+    // An entry is only used while all of these still match the script on disk
+    struct Key {
+        std::string path;
+        std::uintmax_t size;
+        std::int64_t mtime;
+        std::uint64_t hash;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    // Must run before any engine loads a script. Without the on-disk cache chunks are only kept in memory
+    void configure(const core::Config::ScriptConfig& config);
+
+    [[nodiscard]] static std::optional<Key> make_key(const std::filesystem::path& path, std::string_view source);
+
+    [[nodiscard]] std::optional<std::string> find(const Key& key);
+    void store(const Key& key, std::string bytecode);
+
+    // Forgets a chunk Lua refused to load, e.g. one dumped by another Lua version
+    void invalidate(const Key& key);
+
+private:
+    struct Entry {
+        Key key;
+        std::string bytecode;
+    };
+
+    [[nodiscard]] std::filesystem::path file_for(const std::string& path) const;
+    [[nodiscard]] std::optional<std::string> read_file(const Key& key) const;
+    void write_file(const Key& key, std::string_view bytecode) const;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    // Empty while the on-disk cache is disabled
+    std::filesystem::path directory_;
+};
+}
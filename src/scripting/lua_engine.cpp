@@ -1,7 +1,11 @@
 #include "lua_engine.hpp"
 
+#include <fstream>
+#include <iterator>
 #include <spdlog/spdlog.h>
 
+#include "bytecode_cache.hpp"
+
 namespace scripting {
 LuaEngine::LuaEngine()
 {
@@ -54,16 +58,19 @@ bool LuaEngine::execute(const std::string_view script)
 
 bool LuaEngine::execute_file(const std::filesystem::path& path)
 {
-    if (!std::filesystem::exists(path)) {
+    std::ifstream in{ path, std::ios::binary };
+    if (!in) {
         spdlog::error("Script file not found: {}", path.string());
         return false;
     }
 
-    const sol::protected_function_result result{ lua_.safe_script_file(
-        path.string(),
-        sol::script_pass_on_error
-    ) };
+    const std::string source{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+    const auto chunk{ load_file(path, source) };
+    if (!chunk) {
+        return false;
+    }
 
+    const sol::protected_function_result result{ (*chunk)() };
     if (!result.valid()) {
         const sol::error err = result;
         spdlog::error("Failed to execute script file '{}': {}", path.string(), err.what());
@@ -74,6 +81,43 @@ bool LuaEngine::execute_file(const std::filesystem::path& path)
     return true;
 }
 
+std::optional<sol::protected_function> LuaEngine::load_file(const std::filesystem::path& path, const std::string& source)
+{
+    // Same chunk name safe_script_file would use, keeps error messages pointing at the file
+    const auto chunk_name{ "@" + path.string() };
+
+    auto& cache{ BytecodeCache::instance() };
+    const auto key{ BytecodeCache::make_key(path, source) };
+
+    if (key) {
+        if (const auto bytecode{ cache.find(*key) }) {
+            sol::load_result cached{ lua_.load_buffer(bytecode->data(), bytecode->size(), chunk_name, sol::load_mode::binary) };
+            if (cached.valid()) {
+                spdlog::debug("Loaded cached bytecode for {}", path.filename().string());
+                return cached.get<sol::protected_function>();
+            }
+
+            spdlog::debug("Discarding unusable bytecode cache for {}", path.filename().string());
+            cache.invalidate(*key);
+        }
+    }
+
+    sol::load_result loaded{ lua_.load_buffer(source.data(), source.size(), chunk_name, sol::load_mode::text) };
+    if (!loaded.valid()) {
+        const sol::error err = loaded;
+        spdlog::error("Failed to load script file '{}': {}", path.string(), err.what());
+        return std::nullopt;
+    }
+
+    auto chunk{ loaded.get<sol::protected_function>() };
+    if (key) {
+        const sol::bytecode bytecode = chunk.dump();
+        cache.store(*key, std::string{ bytecode.as_string_view() });
+    }
+
+    return chunk;
+}
+
 void LuaEngine::register_binding(std::unique_ptr<IBindingModule> binding)
 {
     if (!binding) {
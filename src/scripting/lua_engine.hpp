@@ -1,5 +1,8 @@
 #pragma once
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include <sol/sol.hpp>
@@ -28,6 +31,12 @@ private:
     void open_safe_libraries();
     void setup_error_handler();
 
+    // Compiles the script, or loads its cached bytecode when the file has not changed
+    [[nodiscard]] std::optional<sol::protected_function> load_file(
+        const std::filesystem::path& path,
+        const std::string& source
+    );
+
 private:
     sol::state lua_;
     std::vector<std::unique_ptr<IBindingModule>> bindings_;
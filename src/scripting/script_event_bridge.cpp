@@ -1,4 +1,5 @@
 #include "script_event_bridge.hpp"
+#include "bindings/packet_bindings.hpp"
 #include "../packet/generic_packets.hpp"
 #include "../packet/packet_types.hpp"
 #include "../packet/packet_variant.hpp"
@@ -42,6 +43,12 @@ const std::unordered_map<std::string, packet::PacketId> PACKET_ID_MAP = {
 };
 }
 
+utils::ByteBuffer LuaEventContext::get_bytes() const
+{
+    check_valid();
+    return bindings::PacketBindings::to_bytes(raw_data);
+}
+
 sol::object LuaEventContext::parse_packet(sol::this_state s)
 {
     check_valid();
@@ -100,18 +107,14 @@ sol::object LuaEventContext::parse_packet(sol::this_state s)
 
 ScriptEventBridge::ScriptEventBridge(
     event::Dispatcher& dispatcher,
-    LuaEngine& engine,
-    network::Client& client,
-    network::Server& server
+    LuaEngine& engine
 )
     : dispatcher_{ dispatcher }
     , engine_{ engine }
-    , client_{ client }
-    , server_{ server }
+    , scopes_{ std::make_shared<DispatchScopes>() }
     , next_handle_{ 0 }
 {
     register_event_context_type();
-    setup_event_listeners();
     spdlog::info("Script event bridge initialized");
 }
 
@@ -120,6 +123,10 @@ ScriptEventBridge::~ScriptEventBridge()
     for (auto& [type, handle] : event_handles_) {
         dispatcher_.removeListener(type, handle);
     }
+
+    for (const auto& entry : callbacks_) {
+        dispatcher_.profiler().untrack(entry->stats.get());
+    }
 }
 
 void ScriptEventBridge::register_event_context_type()
@@ -132,9 +139,10 @@ void ScriptEventBridge::register_event_context_type()
         "type", sol::property(&LuaEventContext::type_name),
         "has_packet", &LuaEventContext::has_packet,
         "is_raw", &LuaEventContext::is_raw,
-        "get_data", [&lua](const LuaEventContext& ctx) {
-            return ctx.get_data(lua);
+        "get_data", [](const LuaEventContext& ctx, sol::this_state s) {
+            return bindings::PacketBindings::to_table(s, ctx.get_bytes().span());
         },
+        "get_bytes", &LuaEventContext::get_bytes,
         "get_packet", [](const LuaEventContext& ctx, sol::this_state s) -> sol::object {
             ctx.check_valid();
             if (!ctx.packet) {
@@ -144,50 +152,50 @@ void ScriptEventBridge::register_event_context_type()
             const auto pid = ctx.packet->id();
             switch (pid) {
                 case packet::PacketId::Input:
-                    return sol::make_object(s, static_cast<packet::message::Input*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::Input*>(ctx.packet));
                 case packet::PacketId::Log:
-                    return sol::make_object(s, static_cast<packet::message::Log*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::Log*>(ctx.packet));
                 case packet::PacketId::JoinRequest:
-                    return sol::make_object(s, static_cast<packet::message::JoinRequest*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::JoinRequest*>(ctx.packet));
                 case packet::PacketId::Quit:
-                    return sol::make_object(s, static_cast<packet::message::Quit*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::Quit*>(ctx.packet));
                 case packet::PacketId::QuitToExit:
-                    return sol::make_object(s, static_cast<packet::message::QuitToExit*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::QuitToExit*>(ctx.packet));
                 case packet::PacketId::ServerHello:
-                    return sol::make_object(s, static_cast<packet::message::ServerHello*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::message::ServerHello*>(ctx.packet));
                 case packet::PacketId::OnSendToServer:
-                    return sol::make_object(s, static_cast<packet::game::OnSendToServer*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnSendToServer*>(ctx.packet));
                 case packet::PacketId::OnNameChanged:
-                    return sol::make_object(s, static_cast<packet::game::OnNameChanged*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnNameChanged*>(ctx.packet));
                 case packet::PacketId::OnChangeSkin:
-                    return sol::make_object(s, static_cast<packet::game::OnChangeSkin*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnChangeSkin*>(ctx.packet));
                 case packet::PacketId::OnSpawn:
-                    return sol::make_object(s, static_cast<packet::game::OnSpawn*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnSpawn*>(ctx.packet));
                 case packet::PacketId::OnRemove:
-                    return sol::make_object(s, static_cast<packet::game::OnRemove*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnRemove*>(ctx.packet));
                 case packet::PacketId::SendMapData:
-                    return sol::make_object(s, static_cast<packet::game::SendMapData*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::SendMapData*>(ctx.packet));
                 case packet::PacketId::SendTileUpdateData:
-                    return sol::make_object(s, static_cast<packet::game::SendTileUpdateData*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::SendTileUpdateData*>(ctx.packet));
                 case packet::PacketId::TileChangeRequest:
-                    return sol::make_object(s, static_cast<packet::game::TileChangeRequest*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::TileChangeRequest*>(ctx.packet));
                 case packet::PacketId::ItemChangeObject:
-                    return sol::make_object(s, static_cast<packet::game::ItemChangeObject*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::ItemChangeObject*>(ctx.packet));
                 case packet::PacketId::OnSuperMainStartAcceptLogonHrdxs47254722215a:
-                    return sol::make_object(s, static_cast<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a*>(ctx.packet.get()));
+                    return sol::make_object(s, static_cast<packet::game::OnSuperMainStartAcceptLogonHrdxs47254722215a*>(ctx.packet));
                 case packet::PacketId::Unknown:
                 default:
                     // Try to cast to generic packet types
-                    if (auto* text_pkt = dynamic_cast<packet::GenericTextPacket*>(ctx.packet.get())) {
+                    if (auto* text_pkt = dynamic_cast<packet::GenericTextPacket*>(ctx.packet)) {
                         return sol::make_object(s, text_pkt);
                     }
-                    if (auto* var_pkt = dynamic_cast<packet::GenericVariantPacket*>(ctx.packet.get())) {
+                    if (auto* var_pkt = dynamic_cast<packet::GenericVariantPacket*>(ctx.packet)) {
                         return sol::make_object(s, var_pkt);
                     }
-                    if (auto* game_pkt = dynamic_cast<packet::GenericGamePacket*>(ctx.packet.get())) {
+                    if (auto* game_pkt = dynamic_cast<packet::GenericGamePacket*>(ctx.packet)) {
                         return sol::make_object(s, game_pkt);
                     }
-                    return sol::make_object(s, ctx.packet.get());
+                    return sol::make_object(s, ctx.packet);
             }
         },
         "parse", &LuaEventContext::parse_packet,
@@ -204,50 +212,51 @@ void ScriptEventBridge::register_event_context_type()
                 return *ctx.direction == event::Direction::ClientBound ? "ClientBound" : "ServerBound";
             }
             return "Unknown";
-        }
+        },
+        "session_id", sol::readonly(&LuaEventContext::session_id)
     );
 }
 
-void ScriptEventBridge::setup_event_listeners()
+void ScriptEventBridge::attach_listener(const event::Type type)
 {
-    auto make_handler = [this](event::Type type) {
-        return [this, type](const event::Event& e) {
-            invoke_callbacks(type, e);
-        };
+    if (event_handles_.contains(type)) {
+        return;
+    }
+
+    const auto name{
+        event::is_packet_event(type)
+            ? magic_enum::enum_name(event::packet_id_from_type(type))
+            : magic_enum::enum_name(type)
     };
 
-    constexpr auto event_values = magic_enum::enum_values<event::Type>();
-    for (const auto type : event_values) {
-        if (type == event::Type::Max) continue;
+    event_handles_[type] = dispatcher_.appendListener(
+        type,
+        [this, type](const event::Event& e) { invoke_callbacks(type, e); },
+        event::Priority::FairlyHigh,
+        fmt::format("ScriptEventBridge::{}", name)
+    );
+    spdlog::debug("Attached script listener for '{}' (type={})", name, static_cast<uint32_t>(type));
+}
 
-        event_handles_[type] = dispatcher_.appendListener(
-            type,
-            make_handler(type),
-            event::Priority::FairlyHigh
-        );
+void ScriptEventBridge::detach_listener(const event::Type type)
+{
+    const auto it{ event_handles_.find(type) };
+    if (it == event_handles_.end()) {
+        return;
     }
 
-    for (const auto& [name, pid] : PACKET_ID_MAP) {
-        const auto type = event::packet_event_type(pid);
-        event_handles_[type] = dispatcher_.appendListener(
-            type,
-            make_handler(type),
-            event::Priority::FairlyHigh
-        );
-        spdlog::debug("Registered packet event listener for '{}' (type={})", name, static_cast<uint32_t>(type));
-    }
+    dispatcher_.removeListener(type, it->second);
+    event_handles_.erase(it);
 }
 
 namespace {
+// Events dispatched under a packet type are always TypedPacketEvent<P>, see PriorityEventDispatcher::on
 template<packet::PacketId P>
-bool fill_typed_context(const event::Event& e, scripting::LuaEventContext& ctx)
+void fill_typed_context(const event::Event& e, scripting::LuaEventContext& ctx)
 {
-    if (const auto* typed_evt = dynamic_cast<const event::TypedPacketEvent<P>*>(&e)) {
-        ctx.packet = typed_evt->packet;
-        ctx.direction = typed_evt->direction;
-        return true;
-    }
-    return false;
+    const auto& typed_evt{ static_cast<const event::TypedPacketEvent<P>&>(e) };
+    ctx.packet = typed_evt.packet.get();
+    ctx.direction = typed_evt.direction;
 }
 
 void try_fill_typed_context(packet::PacketId pid, const event::Event& event, scripting::LuaEventContext& ctx)
@@ -282,45 +291,57 @@ void ScriptEventBridge::invoke_callbacks(event::Type type, const event::Event& e
         return;
     }
 
+    // Held for the whole dispatch, a callback that registers or unregisters only swaps the map entry
+    const auto it{ callbacks_by_type_.find(type) };
+    if (it == callbacks_by_type_.end()) {
+        return;
+    }
+    const auto callbacks{ it->second };
+
+    // Nested dispatches, e.g. a callback sending a packet, finish before the outer one
+    struct ActiveDispatch {
+        DispatchScopes& scopes;
+        std::uint64_t id;
+
+        explicit ActiveDispatch(DispatchScopes& s)
+            : scopes{ s }
+            , id{ ++s.next_id }
+        {
+            scopes.active.push_back(id);
+        }
+
+        ~ActiveDispatch() { scopes.active.pop_back(); }
+    };
+    const ActiveDispatch dispatch{ *scopes_ };
+
     LuaEventContext ctx;
     ctx.type = type;
     ctx.event_ptr = &event;
     ctx.packet = nullptr;
-    ctx.is_valid = std::make_shared<bool>(true);
+    ctx.scopes = scopes_;
+    ctx.dispatch_id = dispatch.id;
+    ctx.session_id = event.session ? event.session->id() : 0;
 
-    if (const auto* raw_event = dynamic_cast<const event::RawPacketEvent*>(&event)) {
-        ctx.raw_data.assign(raw_event->data.begin(), raw_event->data.end());
+    if (type == event::Type::ClientBoundPacket || type == event::Type::ServerBoundPacket) {
+        ctx.raw_data = static_cast<const event::RawPacketEvent&>(event).data;
     }
-
-    if (const auto* pkt_event = dynamic_cast<const event::PacketEvent*>(&event)) {
-        ctx.packet = pkt_event->packet;
-    }
-
-    if (event::is_packet_event(type)) {
+    else if (event::is_packet_event(type)) {
         const auto pid = event::packet_id_from_type(type);
         try_fill_typed_context(pid, event, ctx);
     }
 
-    std::vector<std::shared_ptr<CallbackEntry>> applicable_callbacks;
-    applicable_callbacks.reserve(callbacks_.size());
-
-    for (const auto& entry : callbacks_) {
-        if (entry->type == type) {
-            applicable_callbacks.push_back(entry);
-        }
-    }
-
-    std::ranges::sort(applicable_callbacks, [](const auto& a, const auto& b) {
-        return a->priority < b->priority;
-    });
-
-    for (const auto& entry : applicable_callbacks) {
+    for (const auto& entry : *callbacks) {
         if (event.canceled) {
-            *ctx.is_valid = false;
             return;
         }
 
-        sol::protected_function_result result = entry->callback(ctx);
+        sol::protected_function_result result{};
+        if (dispatcher_.profiler().enabled()) {
+            event::DispatchProfiler::invoke(*entry->stats, event, [&] { result = entry->callback(ctx); });
+        }
+        else {
+            result = entry->callback(ctx);
+        }
 
         if (!result.valid()) {
             sol::error err = result;
@@ -331,14 +352,38 @@ void ScriptEventBridge::invoke_callbacks(event::Type type, const event::Event& e
         if (result.get_type() == sol::type::boolean) {
             if (const bool should_continue{ result.get<bool>() }; !should_continue) {
                 spdlog::debug("Lua callback canceled event: {}", magic_enum::enum_name(type));
+                if (dispatcher_.profiler().enabled() && !event.canceled) {
+                    ++entry->stats->cancels;
+                }
+
                 event.cancel();
-                *ctx.is_valid = false;
                 return;
             }
         }
     }
+}
+
+void ScriptEventBridge::rebuild_callbacks(const event::Type type)
+{
+    auto callbacks{ std::make_shared<CallbackList>() };
+    for (const auto& entry : callbacks_) {
+        if (entry->type == type) {
+            callbacks->push_back(entry);
+        }
+    }
+
+    // The dispatcher only calls into the bridge for types some script listens to, so events
+    // nobody subscribed to cost nothing here and are not decoded for it either
+    if (callbacks->empty()) {
+        callbacks_by_type_.erase(type);
+        detach_listener(type);
+        return;
+    }
 
-    *ctx.is_valid = false;
+    // Equal priorities keep registration order
+    std::ranges::stable_sort(*callbacks, {}, &CallbackEntry::priority);
+    callbacks_by_type_[type] = std::move(callbacks);
+    attach_listener(type);
 }
 
 std::size_t ScriptEventBridge::register_callback(
@@ -356,7 +401,14 @@ std::size_t ScriptEventBridge::register_callback(
 
     const event::Type type{ type_opt.value() };
     std::size_t handle = next_handle_++;
-    callbacks_.push_back(std::make_shared<CallbackEntry>(handle, type, priority, std::move(callback)));
+    callbacks_.push_back(std::make_shared<CallbackEntry>(
+        handle,
+        type,
+        priority,
+        std::move(callback),
+        dispatcher_.profiler().track(fmt::format("lua#{} ({})", handle, event_name), type, priority)
+    ));
+    rebuild_callbacks(type);
 
     spdlog::debug(
         "Registered Lua callback for event '{}' with handle {} (priority {})",
@@ -373,7 +425,10 @@ bool ScriptEventBridge::unregister_callback(std::size_t handle)
         [handle](const std::shared_ptr<CallbackEntry>& entry) { return entry->handle == handle; });
 
     if (it != callbacks_.end()) {
+        const auto type{ (*it)->type };
+        dispatcher_.profiler().untrack((*it)->stats.get());
         callbacks_.erase(it);
+        rebuild_callbacks(type);
         spdlog::debug("Unregistered Lua callback with handle {}", handle);
         return true;
     }
@@ -1,7 +1,9 @@
 #pragma once
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,22 +12,34 @@
 
 #include "lua_engine.hpp"
 #include "../event/event.hpp"
-#include "../network/client.hpp"
-#include "../network/server.hpp"
+#include "../network/session.hpp"
 #include "../packet/packet_helper.hpp"
+#include "../utils/byte_buffer.hpp"
 
 namespace scripting {
+// Ids of the dispatches the bridge is currently running, innermost last. Contexts copied into Lua
+// only work while their own dispatch is still on this stack.
+struct DispatchScopes {
+    std::vector<std::uint64_t> active;
+    std::uint64_t next_id{ 0 };
+};
+
 struct LuaEventContext {
     event::Type type;
     const event::Event* event_ptr;
-    std::vector<std::byte> raw_data;
-    std::shared_ptr<bool> is_valid;
-    std::shared_ptr<packet::IPacket> packet;
+    // Points into the received packet, not owned
+    std::span<const std::byte> raw_data;
+    std::shared_ptr<const DispatchScopes> scopes;
+    std::uint64_t dispatch_id;
+    // Not owned either, the event keeps it alive for the dispatch. A context Lua keeps around must
+    // not keep the packet's share of the received buffer, that would make forwarding it copy.
+    packet::IPacket* packet;
     std::optional<event::Direction> direction;
+    std::uint32_t session_id;
 
     void check_valid() const
     {
-        if (!is_valid || !*is_valid) {
+        if (!scopes || std::ranges::find(scopes->active, dispatch_id) == scopes->active.end()) {
             throw std::runtime_error{ "Event context is no longer valid (event has finished processing)" };
         }
     }
@@ -65,15 +79,8 @@ struct LuaEventContext {
         return !raw_data.empty() && !packet;
     }
 
-    [[nodiscard]] sol::table get_data(sol::state& lua) const
-    {
-        check_valid();
-        sol::table data = lua.create_table();
-        for (size_t i = 0; i < raw_data.size(); ++i) {
-            data[i + 1] = static_cast<int>(raw_data[i]);
-        }
-        return data;
-    }
+    // A copy, the Bytes may outlive the dispatch and must not hold on to the received packet
+    [[nodiscard]] utils::ByteBuffer get_bytes() const;
 
     [[nodiscard]] sol::object parse_packet(sol::this_state s);
 };
@@ -82,9 +89,7 @@ class ScriptEventBridge : public utils::types::Immobile {
 public:
     explicit ScriptEventBridge(
         event::Dispatcher& dispatcher,
-        LuaEngine& engine,
-        network::Client& client,
-        network::Server& server
+        LuaEngine& engine
     );
 
     ~ScriptEventBridge();
@@ -97,14 +102,14 @@ public:
     bool unregister_callback(std::size_t handle);
 
     [[nodiscard]] LuaEngine& engine() const { return engine_; }
-    [[nodiscard]] network::Client& client() const { return client_; }
-    [[nodiscard]] network::Server& server() const { return server_; }
 
     void register_event_context_type();
 
 private:
-    void setup_event_listeners();
+    void attach_listener(event::Type type);
+    void detach_listener(event::Type type);
     void invoke_callbacks(event::Type type, const event::Event& event) const;
+    void rebuild_callbacks(event::Type type);
     static std::optional<event::Type> string_to_event_type(const std::string& name);
 
 private:
@@ -113,14 +118,18 @@ private:
         event::Type type;
         int8_t priority;
         sol::protected_function callback;
+        std::shared_ptr<event::ListenerStats> stats;
     };
 
     event::Dispatcher& dispatcher_;
     LuaEngine& engine_;
-    network::Client& client_;
-    network::Server& server_;
+
+    using CallbackList = std::vector<std::shared_ptr<CallbackEntry>>;
 
     std::vector<std::shared_ptr<CallbackEntry>> callbacks_;
+    // Priority sorted callbacks of each type, rebuilt whenever one registers or leaves
+    std::unordered_map<event::Type, std::shared_ptr<const CallbackList>> callbacks_by_type_;
+    std::shared_ptr<DispatchScopes> scopes_;
     std::unordered_map<event::Type, event::Dispatcher::Handle> event_handles_;
     std::size_t next_handle_;
 };
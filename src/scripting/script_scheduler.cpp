@@ -4,9 +4,19 @@
 #include <spdlog/spdlog.h>
 
 namespace scripting {
+namespace {
+// Min-heap order, ties run in scheduling order
+constexpr auto LATER = [](const auto& a, const auto& b) {
+    return a.deadline != b.deadline ? a.deadline > b.deadline : a.id > b.id;
+};
+}
+
 ScriptScheduler::ScriptScheduler(LuaEngine& engine)
     : engine_{ engine }
     , next_id_{ 1 }
+    , running_id_{ INVALID_TASK_ID }
+    , running_cancelled_{ false }
+    , running_session_{ NO_SESSION }
 {
     spdlog::info("Script scheduler initialized");
 }
@@ -18,135 +28,207 @@ TaskId ScriptScheduler::generate_id()
 
 TaskId ScriptScheduler::schedule(
     std::chrono::milliseconds delay,
-    sol::protected_function callback
+    sol::protected_function callback,
+    const SessionId session
 ) {
-    const auto id{ generate_id() };
-    auto task{ std::make_shared<Task>() };
-    task->id = id;
-    task->remaining = std::chrono::duration_cast<std::chrono::microseconds>(delay);
-    task->interval = std::chrono::microseconds{ 0 };
-    task->callback = std::move(callback);
-    task->periodic = false;
-    task->cancelled = false;
-
-    tasks_.push_back(std::move(task));
-
-    spdlog::debug("Scheduled one-shot task {} with delay {}ms", id, delay.count());
+    const auto id{ add({
+        Clock::now() + delay,
+        Clock::duration::zero(),
+        std::move(callback),
+        CatchUp::Skip,
+        false,
+        session
+    }) };
+
+    spdlog::debug("Scheduled one-shot task {} with delay {}ms (session {})", id, delay.count(), session);
     return id;
 }
 
 TaskId ScriptScheduler::schedule_periodic(
     std::chrono::milliseconds interval,
     sol::protected_function callback,
-    std::chrono::milliseconds initial_delay
+    std::chrono::milliseconds initial_delay,
+    const CatchUp catch_up,
+    const SessionId session
 ) {
+    // A zero interval would keep the task due forever
+    const auto period{ std::max(interval, MIN_INTERVAL) };
+
+    const auto id{ add({
+        Clock::now() + (initial_delay.count() > 0 ? initial_delay : period),
+        period,
+        std::move(callback),
+        catch_up,
+        true,
+        session
+    }) };
+
+    spdlog::debug("Scheduled periodic task {} with interval {}ms (session {})", id, period.count(), session);
+    return id;
+}
+
+TaskId ScriptScheduler::add(Task task)
+{
     const auto id{ generate_id() };
-    auto task{ std::make_shared<Task>() };
-    task->id = id;
-    task->remaining = std::chrono::duration_cast<std::chrono::microseconds>(
-        initial_delay.count() > 0 ? initial_delay : interval
-    );
-    task->interval = std::chrono::duration_cast<std::chrono::microseconds>(interval);
-    task->callback = std::move(callback);
-    task->periodic = true;
-    task->cancelled = false;
-
-    tasks_.push_back(std::move(task));
-
-    spdlog::debug("Scheduled periodic task {} with interval {}ms", id, interval.count());
+    push(task.deadline, id);
+    tasks_.emplace(id, std::move(task));
     return id;
 }
 
+void ScriptScheduler::push(const Clock::time_point deadline, const TaskId id)
+{
+    heap_.push_back({ deadline, id });
+    std::ranges::push_heap(heap_, LATER);
+}
+
 bool ScriptScheduler::cancel(TaskId id)
 {
-    const auto it{ std::ranges::find_if(tasks_,
-        [id](const std::shared_ptr<Task>& task) { return task->id == id; }) };
+    if (id != INVALID_TASK_ID && id == running_id_) {
+        if (running_cancelled_) {
+            return false;
+        }
 
-    if (it != tasks_.end()) {
-        (*it)->cancelled = true;
+        running_cancelled_ = true;
         spdlog::debug("Cancelled task {}", id);
         return true;
     }
 
-    return false;
+    if (tasks_.erase(id) == 0) {
+        return false;
+    }
+
+    drop_stale();
+    compact();
+
+    spdlog::debug("Cancelled task {}", id);
+    return true;
 }
 
 void ScriptScheduler::cancel_all()
 {
-    for (auto& task : tasks_) {
-        task->cancelled = true;
+    const auto count{ pending_count() };
+
+    tasks_.clear();
+    heap_.clear();
+    if (running_id_ != INVALID_TASK_ID) {
+        running_cancelled_ = true;
     }
 
-    spdlog::debug("Cancelled all {} tasks", tasks_.size());
+    spdlog::debug("Cancelled all {} tasks", count);
 }
 
-void ScriptScheduler::update(std::chrono::microseconds elapsed)
+void ScriptScheduler::update(const Clock::time_point now)
 {
-    if (tasks_.empty()) {
-        return;
-    }
-
-    std::vector<std::shared_ptr<Task>> tasks_to_execute;
-
-    for (auto& task : tasks_) {
-        if (task->cancelled) {
-            continue;
+    while (true) {
+        drop_stale();
+        if (heap_.empty() || heap_.front().deadline > now) {
+            return;
         }
 
-        task->remaining -= elapsed;
+        std::ranges::pop_heap(heap_, LATER);
+        const auto id{ heap_.back().id };
+        heap_.pop_back();
 
-        if (task->remaining <= std::chrono::microseconds::zero()) {
-            tasks_to_execute.push_back(task);
-
-            if (task->periodic) {
-                task->remaining = task->interval;
-            }
-        }
+        run(tasks_.extract(id), now);
     }
+}
 
-    for (const auto& task : tasks_to_execute) {
-        if (task->cancelled) {
-            continue;
-        }
+void ScriptScheduler::run(Tasks::node_type node, const Clock::time_point now)
+{
+    auto& task{ node.mapped() };
+    running_id_ = node.key();
+    running_cancelled_ = false;
+    running_session_ = task.session;
 
-        sol::protected_function_result result{ task->callback() };
+    bool keep{ task.periodic };
+    {
+        sol::protected_function_result result{ task.callback() };
 
         if (!result.valid()) {
             sol::error err = result;
-            spdlog::error("Scheduler callback error (task {}): {}", task->id, err.what());
+            spdlog::error("Scheduler callback error (task {}): {}", node.key(), err.what());
         }
         else if (result.get_type() == sol::type::boolean) {
-            if (const bool should_continue{ result.get<bool>() }; !should_continue && task->periodic) {
-                task->cancelled = true;
-                spdlog::debug("Periodic task {} stopped by callback returning false", task->id);
+            if (const bool should_continue{ result.get<bool>() }; !should_continue && task.periodic) {
+                keep = false;
+                spdlog::debug("Periodic task {} stopped by callback returning false", node.key());
             }
         }
+    }
 
-        if (!task->periodic) {
-            task->cancelled = true;
-        }
+    running_id_ = INVALID_TASK_ID;
+    running_session_ = NO_SESSION;
+    if (!keep || running_cancelled_) {
+        return;
     }
 
-    std::erase_if(tasks_, [](const std::shared_ptr<Task>& task) {
-        return task->cancelled;
-    });
+    reschedule(task, now);
+    push(task.deadline, node.key());
+    tasks_.insert(std::move(node));
+}
+
+void ScriptScheduler::reschedule(Task& task, const Clock::time_point now) const
+{
+    if (task.catch_up == CatchUp::Delay) {
+        task.deadline = now + task.interval;
+        return;
+    }
+
+    // Advancing from the previous deadline rather than from now keeps periodic tasks from drifting
+    task.deadline += task.interval;
+    if (task.deadline > now) {
+        return;
+    }
+
+    // Still due, update() runs it again right away
+    if (task.catch_up == CatchUp::Burst && now - task.deadline < task.interval * MAX_BURST) {
+        return;
+    }
+
+    const auto missed{ (now - task.deadline) / task.interval + 1 };
+    task.deadline += task.interval * missed;
+}
+
+void ScriptScheduler::drop_stale()
+{
+    while (!heap_.empty() && !tasks_.contains(heap_.front().id)) {
+        std::ranges::pop_heap(heap_, LATER);
+        heap_.pop_back();
+    }
+}
+
+void ScriptScheduler::compact()
+{
+    // Cancelled entries deeper in the heap wait until they surface, rebuild once they dominate
+    if (heap_.size() <= 2 * tasks_.size() + 64) {
+        return;
+    }
+
+    std::erase_if(heap_, [this](const HeapEntry& entry) { return !tasks_.contains(entry.id); });
+    std::ranges::make_heap(heap_, LATER);
 }
 
 bool ScriptScheduler::is_pending(TaskId id) const
 {
-    return std::ranges::any_of(
-        tasks_,
-        [id](const std::shared_ptr<Task>& task) {
-            return task->id == id && !task->cancelled;
-        }
-    );
+    if (id != INVALID_TASK_ID && id == running_id_) {
+        return !running_cancelled_;
+    }
+
+    return tasks_.contains(id);
 }
 
 std::size_t ScriptScheduler::pending_count() const
 {
-    return std::ranges::count_if(
-        tasks_,
-        [](const std::shared_ptr<Task>& task) { return !task->cancelled; }
-    );
+    const bool running{ running_id_ != INVALID_TASK_ID && !running_cancelled_ };
+    return tasks_.size() + (running ? 1 : 0);
+}
+
+std::optional<ScriptScheduler::Clock::time_point> ScriptScheduler::next_deadline() const
+{
+    if (heap_.empty()) {
+        return std::nullopt;
+    }
+
+    return heap_.front().deadline;
 }
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <chrono>
-#include <memory>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include <sol/sol.hpp>
@@ -12,47 +14,98 @@ namespace scripting {
 using TaskId = std::uint64_t;
 constexpr TaskId INVALID_TASK_ID = 0;
 
+// Id of the session a task was scheduled from, network::Session ids start at 1
+using SessionId = std::uint32_t;
+constexpr SessionId NO_SESSION = 0;
+
+// What a periodic task does after the loop fell behind by more than one interval
+enum class CatchUp {
+    // Run once and continue on the original schedule, missed runs are dropped
+    Skip,
+    // Run once for every missed interval, up to MAX_BURST runs behind
+    Burst,
+    // Run once and count the next interval from now, the schedule drifts by the delay
+    Delay,
+};
+
+// Lua timers on absolute steady_clock deadlines, kept in a min-heap. Cancelling only drops the
+// task from the table, its heap entry is skipped once it surfaces. Each task remembers the session
+// it was scheduled from, running_session() reports it while the callback runs.
 class ScriptScheduler final : public utils::types::Immobile {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds MIN_INTERVAL{ 1 };
+    static constexpr std::size_t MAX_BURST{ 16 };
+
     explicit ScriptScheduler(LuaEngine& engine);
     ~ScriptScheduler() = default;
 
     TaskId schedule(
         std::chrono::milliseconds delay,
-        sol::protected_function callback
+        sol::protected_function callback,
+        SessionId session = NO_SESSION
     );
 
     TaskId schedule_periodic(
         std::chrono::milliseconds interval,
         sol::protected_function callback,
-        std::chrono::milliseconds initial_delay = std::chrono::milliseconds{ 0 }
+        std::chrono::milliseconds initial_delay = std::chrono::milliseconds{ 0 },
+        CatchUp catch_up = CatchUp::Skip,
+        SessionId session = NO_SESSION
     );
 
     bool cancel(TaskId id);
     void cancel_all();
 
-    void update(std::chrono::microseconds elapsed);
+    // Runs every task due at now
+    void update(Clock::time_point now);
 
     [[nodiscard]] bool is_pending(TaskId id) const;
     [[nodiscard]] std::size_t pending_count() const;
+    [[nodiscard]] std::optional<Clock::time_point> next_deadline() const;
+
+    // Session of the task being run, NO_SESSION outside of a callback
+    [[nodiscard]] SessionId running_session() const { return running_session_; }
 
     [[nodiscard]] LuaEngine& engine() const { return engine_; }
 
 private:
     struct Task {
-        TaskId id;
-        std::chrono::microseconds remaining;
-        std::chrono::microseconds interval;
+        Clock::time_point deadline;
+        Clock::duration interval;
         sol::protected_function callback;
+        CatchUp catch_up;
         bool periodic;
-        bool cancelled;
+        SessionId session;
+    };
+
+    struct HeapEntry {
+        Clock::time_point deadline;
+        TaskId id;
     };
 
+    using Tasks = std::unordered_map<TaskId, Task>;
+
     TaskId generate_id();
+    TaskId add(Task task);
+    void push(Clock::time_point deadline, TaskId id);
+    void run(Tasks::node_type node, Clock::time_point now);
+    void reschedule(Task& task, Clock::time_point now) const;
+
+    // Pops cancelled entries off the top, so the top is always a live task
+    void drop_stale();
+    void compact();
 
 private:
     LuaEngine& engine_;
-    std::vector<std::shared_ptr<Task>> tasks_;
+    Tasks tasks_;
+    std::vector<HeapEntry> heap_;
     TaskId next_id_;
+
+    // The task being run is out of tasks_ until its callback returns
+    TaskId running_id_;
+    bool running_cancelled_;
+    SessionId running_session_;
 };
 }
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shared_bytes.hpp"
+
+namespace utils {
+// Byte buffer handed to scripts. It starts as a SharedBytes view of the packet, so reading and
+// slicing never copy, and gets its own copy on the first write while anything else still shares
+// the bytes. Offsets are 0 based, values are read and written little-endian like the protocol.
+class ByteBuffer {
+public:
+    ByteBuffer() = default;
+
+    explicit ByteBuffer(SharedBytes bytes)
+        : bytes_{ std::move(bytes) }
+    { }
+
+    [[nodiscard]] static ByteBuffer zeroed(const std::size_t size)
+    {
+        return ByteBuffer{ SharedBytes{ std::vector<std::byte>(size) } };
+    }
+
+    [[nodiscard]] static ByteBuffer from_string(const std::string_view str)
+    {
+        return ByteBuffer{ SharedBytes::copy_of(std::as_bytes(std::span{ str })) };
+    }
+
+    [[nodiscard]] std::size_t size() const { return bytes_.size(); }
+    [[nodiscard]] bool empty() const { return bytes_.empty(); }
+
+    [[nodiscard]] std::span<const std::byte> span() const { return bytes_.span(); }
+    [[nodiscard]] const SharedBytes& shared() const { return bytes_; }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] std::optional<T> read(const std::size_t offset) const
+    {
+        if (!in_range(offset, sizeof(T))) {
+            return std::nullopt;
+        }
+
+        T value{};
+        std::memcpy(&value, bytes_.data() + offset, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    bool write(const std::size_t offset, const T& value)
+    {
+        return patch(offset, std::as_bytes(std::span{ &value, 1 }));
+    }
+
+    [[nodiscard]] std::optional<std::string> str(const std::size_t offset, const std::size_t count) const
+    {
+        if (!in_range(offset, count)) {
+            return std::nullopt;
+        }
+
+        return std::string{ reinterpret_cast<const char*>(bytes_.data() + offset), count };
+    }
+
+    // Shares the bytes, a write to either side copies first
+    [[nodiscard]] std::optional<ByteBuffer> slice(
+        const std::size_t offset,
+        const std::optional<std::size_t> count = std::nullopt
+    ) const {
+        const std::size_t length{ count.value_or(offset <= size() ? size() - offset : 0) };
+        if (!in_range(offset, length)) {
+            return std::nullopt;
+        }
+
+        return ByteBuffer{ bytes_.subspan(offset, length) };
+    }
+
+    bool patch(const std::size_t offset, const std::span<const std::byte> data)
+    {
+        if (!in_range(offset, data.size())) {
+            return false;
+        }
+
+        if (!data.empty()) {
+            std::memmove(writable() + offset, data.data(), data.size());
+        }
+
+        return true;
+    }
+
+    [[nodiscard]] std::string to_string() const
+    {
+        return std::string{ reinterpret_cast<const char*>(bytes_.data()), bytes_.size() };
+    }
+
+private:
+    [[nodiscard]] bool in_range(const std::size_t offset, const std::size_t count) const
+    {
+        return offset <= size() && count <= size() - offset;
+    }
+
+    [[nodiscard]] std::byte* writable()
+    {
+        // The owner is shared with the packet, a slice or a copy of this buffer, detach from it
+        if (!owned_ || bytes_.use_count() > 1) {
+            auto owned{ std::make_shared<std::vector<std::byte>>(bytes_.to_vector()) };
+            owned_ = owned.get();
+            bytes_ = SharedBytes{ std::move(owned), std::span<const std::byte>{ owned_->data(), owned_->size() } };
+        }
+
+        return owned_->data();
+    }
+
+private:
+    SharedBytes bytes_;
+    // Set once this buffer holds its own copy, bytes_ then views it
+    std::vector<std::byte>* owned_{ nullptr };
+};
+}
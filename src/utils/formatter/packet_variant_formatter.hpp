@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 
 #include "../../packet/packet_variant.hpp"
+#include "../../packet/packet_variant_view.hpp"
 
 template<>
 struct fmt::formatter<packet::variant> {
@@ -54,3 +55,54 @@ struct fmt::formatter<packet::PacketVariant> {
         return out;
     }
 };
+
+template<>
+struct fmt::formatter<packet::variant_view> {
+    constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+    template<typename FormatContext>
+    auto format(const packet::variant_view& var, FormatContext& ctx) const
+    {
+        switch (var.index()) {
+        case 0:
+            return fmt::format_to(ctx.out(), "[FLOAT]: {}", std::get<float>(var));
+        case 1:
+            return fmt::format_to(ctx.out(), "[STRING]: {}", std::get<std::string_view>(var));
+        case 2: {
+            const auto& vec{ std::get<glm::vec2>(var) };
+            return fmt::format_to(ctx.out(), "[VEC2]: x: {}, y: {}", vec.x, vec.y);
+        }
+        case 3: {
+            const auto& vec{ std::get<glm::vec3>(var) };
+            return fmt::format_to(ctx.out(), "[VEC3]: x: {}, y: {}, z: {}", vec.x, vec.y, vec.z);
+        }
+        case 4:
+            return fmt::format_to(ctx.out(), "[UNSIGNED]: {}", std::get<uint32_t>(var));
+        case 5:
+            return fmt::format_to(ctx.out(), "[SIGNED]: {}", std::get<int32_t>(var));
+        default:
+            return fmt::format_to(ctx.out(), "[UNKNOWN]");
+        }
+    }
+};
+
+template<>
+struct fmt::formatter<packet::PacketVariantView> {
+    constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+    template<typename FormatContext>
+    auto format(const packet::PacketVariantView& variant, FormatContext& ctx) const
+    {
+        auto out = ctx.out();
+        const auto slots{ variant.slots() };
+        for (std::size_t i{ 0 }; i < slots.size(); ++i) {
+            if (i > 0) {
+                out = fmt::format_to(out, "\n");
+            }
+
+            out = fmt::format_to(out, "[{}] {}", i, slots[i]);
+        }
+
+        return out;
+    }
+};
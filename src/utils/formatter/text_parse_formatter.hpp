@@ -1,7 +1,9 @@
 #pragma once
 #include <fmt/format.h>
+#include <fmt/ranges.h>
 
 #include "../text_parse.hpp"
+#include "../text_parse_view.hpp"
 
 template<>
 struct fmt::formatter<utils::TextParse> {
@@ -23,3 +25,24 @@ struct fmt::formatter<utils::TextParse> {
         return out;
     }
 };
+
+template<>
+struct fmt::formatter<utils::TextParseView> {
+    constexpr auto parse(format_parse_context& ctx) { return ctx.begin(); }
+
+    template<typename FormatContext>
+    auto format(const utils::TextParseView& text_parse, FormatContext& ctx) const
+    {
+        auto out = ctx.out();
+        const auto& data{ text_parse.get_data() };
+        for (std::size_t i{ 0 }; i < data.size(); ++i) {
+            if (i > 0) {
+                out = fmt::format_to(out, "\n");
+            }
+
+            out = fmt::format_to(out, "{}: {}", data[i].first, fmt::join(data[i].second, "|"));
+        }
+
+        return out;
+    }
+};
@@ -15,6 +15,16 @@ namespace utils::hash {
     return hash;
 }
 
+[[nodiscard]] constexpr uint64_t fnv1a_64(std::string_view str, uint64_t hash = 0xcbf29ce484222325)
+{
+    for (const auto c : str) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
 [[nodiscard]] constexpr uint32_t proton(const char* data, std::size_t length = 0)
 {
     uint32_t hash{ 0x55555555 };
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <optional>
+#include <utility>
+
+#include "types.hpp"
+
+namespace utils {
+// Unbounded multi-producer single-consumer queue, intrusive linked list after Vyukov. push() is
+// wait-free from any thread, a single atomic exchange, pop() belongs to one consumer thread.
+// Items from one producer come out in the order it pushed them.
+//
+// A producer preempted between its exchange and its link hides everything pushed after it until
+// it resumes, so pop() can come back empty while empty() is still false.
+template <typename T>
+class MpscQueue : public types::Immobile {
+public:
+    MpscQueue()
+        : head_{ new Node{} }
+        , tail_{ head_.load(std::memory_order_relaxed) }
+    { }
+
+    ~MpscQueue()
+    {
+        while (pop()) { }
+        delete tail_;
+    }
+
+    void push(T value)
+    {
+        auto* node{ new Node{} };
+        node->value.emplace(std::move(value));
+
+        Node* prev{ head_.exchange(node, std::memory_order_acq_rel) };
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer thread only
+    std::optional<T> pop()
+    {
+        Node* tail{ tail_ };
+        Node* next{ tail->next.load(std::memory_order_acquire) };
+        if (!next) {
+            return std::nullopt;
+        }
+
+        // next becomes the new stub, its value moves out and the old stub is freed
+        std::optional<T> value{ std::move(next->value) };
+        next->value.reset();
+        tail_ = next;
+        delete tail;
+
+        return value;
+    }
+
+    // Consumer thread only, false while a push is still being linked
+    [[nodiscard]] bool empty() const
+    {
+        return head_.load(std::memory_order_acquire) == tail_;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        std::optional<T> value;
+    };
+
+    alignas(64) std::atomic<Node*> head_;
+    alignas(64) Node* tail_;
+};
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace utils {
+namespace detail {
+// Free list of equally sized blocks owned by the calling thread. Blocks released on another thread
+// simply join that thread's list, they all come from the same global operator new.
+template <std::size_t Size, std::size_t Align>
+class FreeList {
+public:
+    static constexpr std::size_t MAX_FREE{ 256 };
+
+    ~FreeList()
+    {
+        while (head_) {
+            release(std::exchange(head_, head_->next));
+        }
+    }
+
+    [[nodiscard]] static FreeList& local()
+    {
+        thread_local FreeList list{};
+        return list;
+    }
+
+    [[nodiscard]] void* allocate()
+    {
+        if (!head_) {
+            return ::operator new(BLOCK_SIZE, std::align_val_t{ BLOCK_ALIGN });
+        }
+
+        --size_;
+        return std::exchange(head_, head_->next);
+    }
+
+    void deallocate(void* ptr)
+    {
+        if (size_ >= MAX_FREE) {
+            release(ptr);
+            return;
+        }
+
+        head_ = ::new (ptr) Node{ head_ };
+        ++size_;
+    }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    static constexpr std::size_t BLOCK_SIZE{ std::max(Size, sizeof(Node)) };
+    static constexpr std::size_t BLOCK_ALIGN{ std::max(Align, alignof(Node)) };
+
+    static void release(void* ptr)
+    {
+        ::operator delete(ptr, BLOCK_SIZE, std::align_val_t{ BLOCK_ALIGN });
+    }
+
+    Node* head_{ nullptr };
+    std::size_t size_{ 0 };
+};
+}
+
+// Stateless allocator recycling single-object allocations through a per-thread free list, meant for
+// std::allocate_shared so the object and its control block come from one pooled block.
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+    [[nodiscard]] T* allocate(const std::size_t n)
+    {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignof(T) }));
+        }
+
+        return static_cast<T*>(free_list().allocate());
+    }
+
+    void deallocate(T* ptr, const std::size_t n) noexcept
+    {
+        if (n != 1) {
+            ::operator delete(ptr, n * sizeof(T), std::align_val_t{ alignof(T) });
+            return;
+        }
+
+        free_list().deallocate(ptr);
+    }
+
+    [[nodiscard]] static auto& free_list() { return detail::FreeList<sizeof(T), alignof(T)>::local(); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+
+// Pooled std::make_shared. Whoever holds the pointer keeps the object alive as usual, the block only
+// goes back to the pool after the last owner releases it.
+template <typename T, typename... Args>
+[[nodiscard]] std::shared_ptr<T> make_pooled(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>{}, std::forward<Args>(args)...);
+}
+}
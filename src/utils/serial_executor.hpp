@@ -0,0 +1,89 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "types.hpp"
+
+namespace utils {
+// Single background thread running posted tasks one at a time, in the order they were posted.
+// Destruction runs whatever is still queued before joining.
+class SerialExecutor : public types::Immobile {
+public:
+    using Task = std::function<void()>;
+
+    SerialExecutor()
+        : thread_{ &SerialExecutor::run, this }
+    { }
+
+    ~SerialExecutor()
+    {
+        {
+            std::scoped_lock lock{ mutex_ };
+            stopping_ = true;
+        }
+
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    void post(Task task)
+    {
+        {
+            std::scoped_lock lock{ mutex_ };
+            tasks_.push_back(std::move(task));
+        }
+
+        wake_.notify_one();
+    }
+
+    // Blocks until every task posted so far has finished. Returns right away on the executor thread,
+    // a task waiting for itself would never wake up.
+    void wait_idle()
+    {
+        if (std::this_thread::get_id() == thread_.get_id()) {
+            return;
+        }
+
+        std::unique_lock lock{ mutex_ };
+        idle_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock{ mutex_ };
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+
+            auto task{ std::move(tasks_.front()) };
+            tasks_.pop_front();
+            busy_ = true;
+
+            lock.unlock();
+            task();
+            lock.lock();
+
+            busy_ = false;
+            if (tasks_.empty()) {
+                idle_.notify_all();
+            }
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Task> tasks_;
+    bool busy_{ false };
+    bool stopping_{ false };
+    std::thread thread_;
+};
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace utils {
+// Refcounted read-only view of a byte buffer. Copies and subspans share the owner instead of the
+// bytes, so a received packet can be handed through decoding and dispatch without being copied.
+class SharedBytes {
+public:
+    SharedBytes() = default;
+
+    SharedBytes(std::shared_ptr<const void> owner, const std::span<const std::byte> bytes)
+        : owner_{ std::move(owner) }
+        , bytes_{ bytes }
+    { }
+
+    // Takes ownership of the vector, used by code that builds payloads itself.
+    SharedBytes(std::vector<std::byte>&& bytes)
+    {
+        auto owner{ std::make_shared<const std::vector<std::byte>>(std::move(bytes)) };
+        bytes_ = { owner->data(), owner->size() };
+        owner_ = std::move(owner);
+    }
+
+    [[nodiscard]] static SharedBytes copy_of(const std::span<const std::byte> bytes)
+    {
+        return SharedBytes{ std::vector<std::byte>{ bytes.begin(), bytes.end() } };
+    }
+
+    [[nodiscard]] SharedBytes subspan(const std::size_t offset, const std::size_t count = std::dynamic_extent) const
+    {
+        return { owner_, bytes_.subspan(offset, count) };
+    }
+
+    [[nodiscard]] std::vector<std::byte> to_vector() const { return { bytes_.begin(), bytes_.end() }; }
+
+    [[nodiscard]] std::span<const std::byte> span() const { return bytes_; }
+    operator std::span<const std::byte>() const { return bytes_; }
+
+    [[nodiscard]] const std::byte* data() const { return bytes_.data(); }
+    [[nodiscard]] std::size_t size() const { return bytes_.size(); }
+    [[nodiscard]] bool empty() const { return bytes_.empty(); }
+
+    [[nodiscard]] auto begin() const { return bytes_.begin(); }
+    [[nodiscard]] auto end() const { return bytes_.end(); }
+
+    const std::byte& operator[](const std::size_t index) const { return bytes_[index]; }
+
+    [[nodiscard]] long use_count() const { return owner_.use_count(); }
+
+private:
+    std::shared_ptr<const void> owner_;
+    std::span<const std::byte> bytes_;
+};
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "text_parse.hpp"
+
+namespace utils {
+// Read-only TextParse over a buffer owned by someone else, keys and values are views into it. Same
+// parsing rules and get<T> API as TextParse, call to_owned() before modifying anything.
+class TextParseView {
+public:
+    TextParseView() = default;
+    explicit TextParseView(const std::string_view str, const std::string_view delimiter = "|")
+    {
+        parse(str, delimiter);
+    }
+
+    void parse(std::string_view str, const std::string_view delimiter = "|")
+    {
+        lines_.clear();
+        values_.clear();
+
+        if (str.empty() || delimiter.empty()) {
+            return;
+        }
+
+        while (!str.empty()) {
+            const auto end{ str.find('\n') };
+            parse_line(str.substr(0, end), delimiter);
+            str = end == std::string_view::npos ? std::string_view{} : str.substr(end + 1);
+        }
+    }
+
+    template <typename T = std::string>
+    [[nodiscard]] T get(const std::string_view key, const int index = 0) const
+    {
+        const auto it{ std::ranges::find(lines_, key, &Line::key) };
+        if (it == lines_.end() || index < 0 || index >= static_cast<int>(it->count)) {
+            return {};
+        }
+
+        const std::string_view val{ values_[it->first + index] };
+
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return val;
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string{ val };
+        }
+        else {
+            if (val.empty()) {
+                return {};
+            }
+
+#ifdef __clang__
+            if constexpr (std::is_integral_v<T>) {
+#else
+            if constexpr (std::is_arithmetic_v<T>) {
+#endif
+                T result{};
+                auto [ptr, ec] = std::from_chars(val.data(), val.data() + val.size(), result);
+                if (ec == std::errc{}) {
+                    return result;
+                }
+            }
+#if __clang__
+            else if constexpr (std::is_floating_point_v<T>) {
+                // Same fallback as TextParse::get, std::from_chars for floating-point may be deleted.
+                try {
+                    const std::string owned{ val };
+                    if constexpr (std::is_same_v<T, float>) {
+                        return std::stof(owned);
+                    }
+
+                    if constexpr (std::is_same_v<T, double>) {
+                        return std::stod(owned);
+                    }
+
+                    if constexpr (std::is_same_v<T, long double>) {
+                        return std::stold(owned);
+                    }
+                } catch (...) { }
+            }
+#endif
+        }
+
+        return {};
+    }
+
+    [[nodiscard]] bool contains(const std::string_view key) const
+    {
+        return std::ranges::find(lines_, key, &Line::key) != lines_.end();
+    }
+
+    [[nodiscard]] bool empty() const { return lines_.empty(); }
+    [[nodiscard]] std::size_t size() const { return lines_.size(); }
+
+    // Keys with their values, in line order.
+    [[nodiscard]] std::vector<std::pair<std::string_view, std::vector<std::string_view>>> get_data() const
+    {
+        std::vector<std::pair<std::string_view, std::vector<std::string_view>>> data{};
+        data.reserve(lines_.size());
+
+        for (const auto& [key, first, count] : lines_) {
+            data.emplace_back(key, std::vector<std::string_view>{
+                values_.begin() + first,
+                values_.begin() + first + count
+            });
+        }
+
+        return data;
+    }
+
+    [[nodiscard]] TextParse to_owned() const
+    {
+        TextParse text_parse{};
+        for (const auto& [key, first, count] : lines_) {
+            std::vector<std::string> values{};
+            values.reserve(count);
+
+            for (std::uint32_t i{ 0 }; i < count; ++i) {
+                values.emplace_back(values_[first + i]);
+            }
+
+            text_parse.add(std::string{ key }, std::move(values));
+        }
+
+        return text_parse;
+    }
+
+private:
+    void parse_line(std::string_view line, const std::string_view delimiter)
+    {
+        const auto first{ values_.size() };
+
+        // Matches TextParse::tokenize, empty tokens are kept except in front of the key
+        std::string_view key{};
+        bool has_key{ false };
+        std::size_t start{ 0 };
+
+        while (true) {
+            const auto end{ line.find(delimiter, start) };
+            const auto token{ line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start) };
+
+            if (has_key) {
+                values_.push_back(token);
+            }
+            else if (!token.empty()) {
+                key = token;
+                has_key = true;
+            }
+
+            if (end == std::string_view::npos) {
+                break;
+            }
+
+            start = end + delimiter.size();
+        }
+
+        if (!has_key || values_.size() == first) {
+            values_.resize(first);
+            return;
+        }
+
+        lines_.push_back({
+            key,
+            static_cast<std::uint32_t>(first),
+            static_cast<std::uint32_t>(values_.size() - first)
+        });
+    }
+
+private:
+    struct Line {
+        std::string_view key;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    std::vector<Line> lines_;
+    std::vector<std::string_view> values_;
+};
+}
@@ -8,10 +8,11 @@
 #include "tile_map.hpp"
 #include "../player/player.hpp"
 #include "../utils/byte_stream.hpp"
-#include "../utils/singleton.hpp"
 
 namespace world {
-class World : public utils::Singleton<World> {
+// What one session has seen of its current world. Owned by network::Session, so every player
+// tracks their own world and all access stays on the session's shard.
+class World {
 public:
     World()
         : local_net_id_{ -1 }
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "core/scheduler.hpp"
+
+using namespace core;
+using namespace std::chrono_literals;
+
+TEST(SchedulerTest, RunsEveryTaskWhileStealing)
+{
+    Scheduler scheduler{ 8 };
+    std::atomic<int> count{ 0 };
+
+    // Tasks scheduled from inside a worker land on its own deque, the others have to steal them
+    for (int i{ 0 }; i < 100; ++i) {
+        scheduler.schedule_immediate([&scheduler, &count] {
+            for (int j{ 0 }; j < 100; ++j) {
+                scheduler.schedule_immediate([&count] { count.fetch_add(1); });
+            }
+        });
+    }
+
+    for (int i{ 0 }; i < 10000; ++i) {
+        scheduler.schedule_immediate([&count] { count.fetch_add(1); });
+    }
+
+    // The nested tasks are only scheduled once their parent ran
+    while (count.load() < 20000) {
+        scheduler.wait_all();
+    }
+
+    scheduler.wait_all();
+    EXPECT_EQ(count.load(), 20000);
+    EXPECT_EQ(scheduler.pending_count(), 0u);
+    EXPECT_GE(scheduler.worker_count(), 1u);
+    EXPECT_LE(scheduler.worker_count(), 8u);
+}
+
+TEST(SchedulerTest, StopsWithQueuedAndDelayedTasks)
+{
+    for (int round{ 0 }; round < 50; ++round) {
+        Scheduler scheduler{ 4 };
+        std::atomic<int> count{ 0 };
+
+        for (int i{ 0 }; i < 1000; ++i) {
+            scheduler.schedule_immediate([&count] { count.fetch_add(1); });
+        }
+
+        scheduler.schedule_delayed([&count] { count.fetch_add(1); }, 1h);
+        scheduler.schedule_periodic([&count] { count.fetch_add(1); }, 1ms);
+
+        scheduler.stop();
+
+        // Nothing is left that could keep these waiting
+        scheduler.wait_all();
+        EXPECT_EQ(scheduler.pending_count(), 0u);
+        EXPECT_EQ(scheduler.schedule_immediate([] { }), INVALID_TASK_ID);
+    }
+}
+
+TEST(SchedulerTest, CancelsPeriodicTaskById)
+{
+    Scheduler scheduler{ 2 };
+    std::atomic<int> runs{ 0 };
+
+    const auto id{ scheduler.schedule_periodic([&runs] { runs.fetch_add(1); }, 1ms) };
+    while (runs.load() < 3) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    // Keeps its id across runs, cancelling it between or during a run stops it for good
+    EXPECT_TRUE(scheduler.cancel(id));
+    scheduler.wait_all();
+
+    const auto after_cancel{ runs.load() };
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(runs.load(), after_cancel);
+    EXPECT_FALSE(scheduler.is_pending(id));
+}
+
+TEST(SchedulerTest, CountsAndCancelsByTag)
+{
+    Scheduler scheduler{ 2 };
+    std::atomic<int> runs{ 0 };
+
+    scheduler.schedule_delayed([&runs] { runs.fetch_add(1); }, 1h, "a");
+    scheduler.schedule_delayed([&runs] { runs.fetch_add(1); }, 1h, "a");
+    const auto other{ scheduler.schedule_delayed([&runs] { runs.fetch_add(1); }, 1h, "b") };
+
+    EXPECT_EQ(scheduler.pending_count(), 3u);
+    EXPECT_EQ(scheduler.pending_count_by_tag("a"), 2u);
+    EXPECT_EQ(scheduler.cancel_by_tag("a"), 2u);
+    EXPECT_EQ(scheduler.pending_count_by_tag("a"), 0u);
+    EXPECT_TRUE(scheduler.is_pending(other));
+
+    scheduler.cancel_all();
+    scheduler.wait_all();
+    EXPECT_EQ(scheduler.pending_count(), 0u);
+    EXPECT_EQ(runs.load(), 0);
+}
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+#include "event/event.hpp"
+
+using namespace event;
+
+TEST(DispatchProfilerTest, ForgetsRemovedListeners)
+{
+    Dispatcher dispatcher{};
+    dispatcher.profiler().set_enabled(true);
+
+    const auto kept{ dispatcher.appendListener(Type::ClientConnect, [](const Event&) { }, Priority::Normal, "kept") };
+    for (int i{ 0 }; i < 100; ++i) {
+        const auto handle{ dispatcher.appendListener(Type::ClientConnect, [](const Event&) { }, Priority::Normal, "temporary") };
+        dispatcher.dispatch(ConnectionEvent{ Type::ClientConnect });
+        EXPECT_TRUE(dispatcher.removeListener(Type::ClientConnect, handle));
+    }
+
+    const auto snapshot{ dispatcher.profiler().snapshot() };
+    ASSERT_EQ(snapshot.size(), 1u);
+    EXPECT_EQ(snapshot[0].tag, "kept");
+    EXPECT_EQ(snapshot[0].calls, 100u);
+
+    EXPECT_TRUE(dispatcher.removeListener(Type::ClientConnect, kept));
+    EXPECT_TRUE(dispatcher.profiler().snapshot().empty());
+}
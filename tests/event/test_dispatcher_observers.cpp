@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "event/event.hpp"
+#include "packet/packet_event_registry.hpp"
+#include "packet/message/server_hello.hpp"
+
+using namespace event;
+using packet::event_registry::PacketEventRegistry;
+
+namespace {
+constexpr auto Timeout{ std::chrono::seconds{ 2 } };
+
+std::vector<std::byte> bytes(std::initializer_list<int> values)
+{
+    std::vector<std::byte> result{};
+    for (const auto value : values) {
+        result.push_back(static_cast<std::byte>(value));
+    }
+    return result;
+}
+
+class DispatcherObserverTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite()
+    {
+        PacketEventRegistry::instance().register_event(
+            packet::PacketId::ServerHello,
+            packet::event_registry::make_event_builder<packet::message::ServerHello, packet::PacketId::ServerHello>()
+        );
+    }
+
+    Dispatcher dispatcher_{};
+};
+}
+
+TEST_F(DispatcherObserverTest, ObserversGetDetachedCopiesAfterFlush)
+{
+    std::promise<std::vector<std::byte>> raw_promise{};
+    std::promise<std::vector<std::byte>> typed_promise{};
+    std::atomic<std::uint32_t> typed_session{ 0 };
+
+    const auto raw_handle{ dispatcher_.observe_raw_packet(Direction::ClientBound, [&](const ObservedPacket& observed) {
+        raw_promise.set_value(observed.data.to_vector());
+    }) };
+    const auto typed_handle{ dispatcher_.observe<packet::PacketId::ServerHello>(Direction::ClientBound, [&](const ObservedPacket& observed) {
+        const auto hello{ observed.get<packet::message::ServerHello>() };
+        typed_session = observed.session_id;
+        typed_promise.set_value(hello ? hello->raw_data.to_vector() : std::vector<std::byte>{});
+    }) };
+
+    // Stands in for the ENet packet buffer, which is reused as soon as forwarding is done
+    auto buffer{ bytes({ 1, 0, 0, 0, 0x42 }) };
+    auto hello{ std::make_shared<packet::message::ServerHello>() };
+    hello->raw_data = utils::SharedBytes{ nullptr, buffer };
+
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ClientBound, 7, buffer, hello);
+
+    auto raw_future{ raw_promise.get_future() };
+    auto typed_future{ typed_promise.get_future() };
+    EXPECT_EQ(raw_future.wait_for(std::chrono::milliseconds{ 50 }), std::future_status::timeout);
+
+    const auto original{ buffer };
+    std::ranges::fill(buffer, std::byte{ 0xFF });
+    dispatcher_.flush_observers();
+
+    ASSERT_EQ(raw_future.wait_for(Timeout), std::future_status::ready);
+    ASSERT_EQ(typed_future.wait_for(Timeout), std::future_status::ready);
+    EXPECT_EQ(raw_future.get(), original);
+    EXPECT_EQ(typed_future.get(), original);
+    EXPECT_EQ(typed_session.load(), 7u);
+
+    dispatcher_.removeListener(raw_packet_type(Direction::ClientBound), raw_handle);
+    dispatcher_.removeListener(packet_event_type(packet::PacketId::ServerHello), typed_handle);
+}
+
+TEST_F(DispatcherObserverTest, QueuesNothingForTypesWithoutObservers)
+{
+    const auto unobserved{ bytes({ 1 }) };
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ServerBound, 1, unobserved);
+    EXPECT_FALSE(dispatcher_.has_observers(raw_packet_type(Direction::ServerBound)));
+
+    std::atomic<int> calls{ 0 };
+    std::promise<std::vector<std::byte>> promise{};
+    const auto handle{ dispatcher_.observe_raw_packet(Direction::ServerBound, [&](const ObservedPacket& observed) {
+        ++calls;
+        promise.set_value(observed.data.to_vector());
+    }) };
+    EXPECT_TRUE(dispatcher_.has_observers(raw_packet_type(Direction::ServerBound)));
+
+    // Client-bound packets are a different type, they do not reach a server-bound observer
+    const auto other_direction{ bytes({ 3 }) };
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ClientBound, 1, other_direction);
+
+    const auto observed{ bytes({ 2 }) };
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ServerBound, 1, observed);
+    dispatcher_.flush_observers();
+
+    auto future{ promise.get_future() };
+    ASSERT_EQ(future.wait_for(Timeout), std::future_status::ready);
+    EXPECT_EQ(future.get(), observed);
+
+    dispatcher_.removeListener(raw_packet_type(Direction::ServerBound), handle);
+    EXPECT_EQ(calls.load(), 1);
+}
+
+TEST_F(DispatcherObserverTest, RemovalDuringFlushWaitsForTheRunningCall)
+{
+    std::atomic<int> calls{ 0 };
+    std::atomic<bool> in_call{ false };
+    std::promise<void> started{};
+
+    const auto handle{ dispatcher_.observe_raw_packet(Direction::ClientBound, [&](const ObservedPacket&) {
+        in_call = true;
+        if (calls.fetch_add(1) == 0) {
+            started.set_value();
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 200 });
+        }
+        in_call = false;
+    }) };
+
+    const auto first{ bytes({ 1 }) };
+    const auto second{ bytes({ 2 }) };
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ClientBound, 1, first);
+    PacketEventRegistry::instance().observe(dispatcher_, Direction::ClientBound, 1, second);
+    dispatcher_.flush_observers();
+
+    ASSERT_EQ(started.get_future().wait_for(Timeout), std::future_status::ready);
+    EXPECT_TRUE(dispatcher_.removeListener(raw_packet_type(Direction::ClientBound), handle));
+
+    // The running call finished before removal returned, the second delivery was dropped
+    EXPECT_FALSE(in_call.load());
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_FALSE(dispatcher_.has_observers(raw_packet_type(Direction::ClientBound)));
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "item/item_database.hpp"
+
+using namespace item;
+
+namespace {
+// Header only, an items.dat without items
+std::vector<std::byte> make_items_dat(const std::uint16_t version)
+{
+    std::vector<std::byte> data(sizeof(std::uint16_t) + sizeof(std::uint32_t));
+    std::memcpy(data.data(), &version, sizeof(version));
+    return data;
+}
+}
+
+TEST(ItemDatabaseTest, NewerItemsDatReplacesTheSnapshot)
+{
+    auto& database{ ItemDatabase::instance() };
+
+    ASSERT_TRUE(database.parse(make_items_dat(20)));
+    const auto first{ database.snapshot() };
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(database.get_version(), 20);
+
+    ASSERT_TRUE(database.parse(make_items_dat(21)));
+    EXPECT_EQ(database.get_version(), 21);
+    EXPECT_NE(database.snapshot(), first);
+
+    // Readers that took the old snapshot keep it
+    EXPECT_EQ(first->version, 20);
+}
+
+TEST(ItemDatabaseTest, SameItemsDatIsNotParsedAgain)
+{
+    auto& database{ ItemDatabase::instance() };
+
+    ASSERT_TRUE(database.parse(make_items_dat(22)));
+    const auto current{ database.snapshot() };
+    ASSERT_NE(current, nullptr);
+    EXPECT_TRUE(database.is_current(current->hash));
+
+    ASSERT_TRUE(database.parse(make_items_dat(22)));
+    EXPECT_EQ(database.snapshot(), current);
+}
+
+TEST(ItemDatabaseTest, FailedParseKeepsTheCurrentSnapshot)
+{
+    auto& database{ ItemDatabase::instance() };
+
+    ASSERT_TRUE(database.parse(make_items_dat(23)));
+    const auto current{ database.snapshot() };
+
+    const std::vector<std::byte> truncated(1);
+    EXPECT_FALSE(database.parse(truncated));
+    EXPECT_EQ(database.snapshot(), current);
+    EXPECT_EQ(database.get_item(0), nullptr);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "packet/packet_variant.hpp"
+#include "packet/packet_variant_view.hpp"
+
+using namespace packet;
+
+namespace {
+PacketVariant make_variant()
+{
+    PacketVariant variant{};
+    variant.add(std::string{ "OnConsoleMessage" });
+    variant.add(1.5f);
+    variant.add(glm::vec2{ 2.0f, 3.0f });
+    variant.add(glm::vec3{ 4.0f, 5.0f, 6.0f });
+    variant.add(uint32_t{ 7 });
+    variant.add(int32_t{ -8 });
+    return variant;
+}
+}
+
+TEST(PacketVariantViewTest, ReadsEveryArgumentType)
+{
+    const auto data{ make_variant().serialize() };
+
+    PacketVariantView view{};
+    ASSERT_TRUE(view.deserialize(data));
+    ASSERT_EQ(view.size(), 6u);
+
+    EXPECT_EQ(view.function_name(), "OnConsoleMessage");
+    EXPECT_FLOAT_EQ(view.get<float>(1), 1.5f);
+    EXPECT_EQ(view.get<glm::vec2>(2), (glm::vec2{ 2.0f, 3.0f }));
+    EXPECT_EQ(view.get<glm::vec3>(3), (glm::vec3{ 4.0f, 5.0f, 6.0f }));
+    EXPECT_EQ(view.get<uint32_t>(4), 7u);
+    EXPECT_EQ(view.get<int32_t>(5), -8);
+}
+
+TEST(PacketVariantViewTest, StringsPointIntoTheBuffer)
+{
+    const auto data{ make_variant().serialize() };
+
+    PacketVariantView view{};
+    ASSERT_TRUE(view.deserialize(data));
+
+    const auto name{ view.get<std::string_view>(0) };
+    const auto* begin{ reinterpret_cast<const char*>(data.data()) };
+    EXPECT_GE(name.data(), begin);
+    EXPECT_LE(name.data() + name.size(), begin + data.size());
+    EXPECT_EQ(view.get<std::string>(0), "OnConsoleMessage");
+}
+
+TEST(PacketVariantViewTest, ToOwnedRoundTrips)
+{
+    const auto data{ make_variant().serialize() };
+
+    PacketVariantView view{};
+    ASSERT_TRUE(view.deserialize(data));
+    EXPECT_EQ(view.to_owned().serialize(), data);
+}
+
+TEST(PacketVariantViewTest, MissingOrMismatchedArgumentsAreDefault)
+{
+    const auto data{ make_variant().serialize() };
+
+    PacketVariantView view{};
+    ASSERT_TRUE(view.deserialize(data));
+
+    EXPECT_EQ(view.get<int32_t>(0), 0);
+    EXPECT_TRUE(view.get<std::string_view>(1).empty());
+    EXPECT_EQ(view.get<uint32_t>(view.size()), 0u);
+}
+
+TEST(PacketVariantViewTest, RejectsTruncatedData)
+{
+    const auto data{ make_variant().serialize() };
+
+    for (std::size_t size{ 0 }; size < data.size(); ++size) {
+        PacketVariantView view{};
+        EXPECT_FALSE(view.deserialize({ data.data(), size })) << "accepted " << size << " of " << data.size() << " bytes";
+    }
+}
+
+TEST(PacketVariantViewTest, LeavesTooManyArgumentsToPacketVariant)
+{
+    PacketVariant variant{};
+    variant.add(std::string{ "OnDialogRequest" });
+    for (int32_t i{ 1 }; i <= static_cast<int32_t>(PacketVariantView::MAX_SIZE); ++i) {
+        variant.add(i);
+    }
+
+    const auto data{ variant.serialize() };
+    EXPECT_FALSE(PacketVariantView::fits(data));
+
+    PacketVariantView view{};
+    EXPECT_FALSE(view.deserialize(data));
+
+    // The decoder falls back to an owning variant for these
+    PacketVariant owned{};
+    ASSERT_TRUE(owned.deserialize(data));
+    ASSERT_EQ(owned.size(), PacketVariantView::MAX_SIZE + 1);
+    EXPECT_EQ(owned.function_name(), "OnDialogRequest");
+    EXPECT_EQ(owned.get<int32_t>(PacketVariantView::MAX_SIZE), static_cast<int32_t>(PacketVariantView::MAX_SIZE));
+}
+
+TEST(PacketVariantViewTest, FitsUpToMaxSize)
+{
+    PacketVariant variant{};
+    variant.add(std::string{ "OnDialogRequest" });
+    for (int32_t i{ 1 }; i < static_cast<int32_t>(PacketVariantView::MAX_SIZE); ++i) {
+        variant.add(i);
+    }
+
+    const auto data{ variant.serialize() };
+    EXPECT_TRUE(PacketVariantView::fits(data));
+
+    PacketVariantView view{};
+    ASSERT_TRUE(view.deserialize(data));
+    EXPECT_EQ(view.size(), PacketVariantView::MAX_SIZE);
+    EXPECT_FALSE(PacketVariantView::fits({}));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include "packet/packet_id.hpp"
+
+using namespace packet;
+
+TEST(TextActionTest, MatchesEveryAction)
+{
+    for (const auto& [name, id] : text_action::ENTRIES) {
+        const std::string text{ "action|" + std::string{ name } };
+        EXPECT_EQ(text_action::match(text), id) << text;
+        EXPECT_EQ(text_action::match(text + "\n"), id) << text;
+        EXPECT_EQ(text_action::match(text + "\r\n"), id) << text;
+        EXPECT_EQ(text_action::match(text + std::string(1, '\0')), id) << text;
+        EXPECT_EQ(text_action::match(text + "\nname|EXIT\ninvitedWorld|0"), id) << text;
+    }
+}
+
+TEST(TextActionTest, MatchesAtCompileTime)
+{
+    static_assert(text_action::match("action|quit") == PacketId::Quit);
+    static_assert(text_action::match("action|quit_to_exit") == PacketId::QuitToExit);
+    static_assert(text_action::match("action|fake") == PacketId::Unknown);
+}
+
+TEST(TextActionTest, SkipsLinesWithoutDelimiter)
+{
+    EXPECT_EQ(text_action::match("\naction|join_request\nname|START"), PacketId::JoinRequest);
+    EXPECT_EQ(text_action::match("garbage\naction|input\n|text|hi"), PacketId::Input);
+}
+
+TEST(TextActionTest, RejectsNearMisses)
+{
+    constexpr std::string_view near_misses[]{
+        "action|qui",
+        "action|quitt",
+        "action|quit_to",
+        "action|quit_to_exi",
+        "action|Quit",
+        "action|QUIT",
+        "action| quit",
+        "action|quit ",
+        "action|join",
+        "action|join_requests",
+        "action|validate_worlds",
+        "action|inputs",
+        "action|lo",
+        "action|logs",
+        "action|log|extra",
+        "actions|quit",
+        "Action|quit",
+        "action:quit",
+        "action quit",
+    };
+
+    for (const auto text : near_misses) {
+        EXPECT_EQ(text_action::match(text), PacketId::Unknown) << text;
+    }
+}
+
+TEST(TextActionTest, RejectsUnknownAndMalformedText)
+{
+    constexpr std::string_view rejected[]{
+        "",
+        "\n",
+        "action|",
+        "action|\r\n",
+        "quit",
+        "action",
+        "|quit",
+        "action|refresh_item_data",
+        "action|enter_game",
+        "action|dialog_return",
+        "requestedName|\naction|quit",
+        "name|quit\naction|quit",
+    };
+
+    for (const auto text : rejected) {
+        EXPECT_EQ(text_action::match(text), PacketId::Unknown) << text;
+    }
+}
+
+TEST(TextActionTest, TableHasNoDuplicates)
+{
+    for (std::size_t i{ 0 }; i < text_action::ENTRIES.size(); ++i) {
+        for (std::size_t j{ i + 1 }; j < text_action::ENTRIES.size(); ++j) {
+            EXPECT_NE(text_action::ENTRIES[i].name, text_action::ENTRIES[j].name);
+            EXPECT_NE(text_action::ENTRIES[i].id, text_action::ENTRIES[j].id);
+        }
+    }
+}
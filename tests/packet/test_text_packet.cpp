@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "packet/generic_packets.hpp"
+#include "packet/message/exit.hpp"
+
+using namespace packet;
+
+namespace {
+utils::SharedBytes make_message(const std::string_view text)
+{
+    std::vector<std::byte> data(sizeof(NetMessageType) + text.size() + 1);
+    const NetMessageType type{ NET_MESSAGE_GAME_MESSAGE };
+    std::memcpy(data.data(), &type, sizeof(type));
+    std::memcpy(data.data() + sizeof(type), text.data(), text.size());
+    return utils::SharedBytes{ std::move(data) };
+}
+
+TextPayload decode(const utils::SharedBytes& data)
+{
+    return TextPayload{ NET_MESSAGE_GAME_MESSAGE, utils::TextParseView{ TextPayload::message_of(data) }, data };
+}
+}
+
+TEST(TextPacketTest, MessageOfSkipsTypeAndTerminator)
+{
+    const auto data{ make_message("action|quit") };
+    EXPECT_EQ(TextPayload::message_of(data), "action|quit");
+    EXPECT_TRUE(TextPayload::message_of({}).empty());
+}
+
+TEST(TextPacketTest, ReadsFieldsFromTheView)
+{
+    const auto data{ make_message("action|join_request\nname|START\ninvitedWorld|1") };
+
+    message::JoinRequest packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+    EXPECT_EQ(packet.world_name, "START");
+    EXPECT_TRUE(packet.invited_world);
+}
+
+TEST(TextPacketTest, BuildsTheTextParseOnFirstUse)
+{
+    const auto data{ make_message("action|join_request\nname|START\ninvitedWorld|0") };
+
+    message::JoinRequest packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+
+    auto& text_parse{ packet.text_parse() };
+    EXPECT_EQ(text_parse.get("action"), "join_request");
+    EXPECT_EQ(text_parse.get("name"), "START");
+
+    text_parse.set("name", { "OTHER" });
+    EXPECT_EQ(packet.text_parse().get("name"), "OTHER");
+}
+
+TEST(TextPacketTest, ReadsOwningPayloads)
+{
+    utils::TextParse text{};
+    text.add("action", "join_request");
+    text.add("name", "START");
+
+    message::JoinRequest packet{};
+    ASSERT_TRUE(packet.read(TextPayload{ NET_MESSAGE_GAME_MESSAGE, text }));
+    EXPECT_EQ(packet.world_name, "START");
+    EXPECT_EQ(packet.text_parse().get("action"), "join_request");
+}
+
+TEST(TextPacketTest, GenericPacketWritesItsText)
+{
+    const auto data{ make_message("action|refresh_item_data") };
+
+    GenericTextPacket packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+
+    const auto payload{ packet.write() };
+    const auto* text{ get_payload_if<TextPayload>(payload) };
+    ASSERT_NE(text, nullptr);
+    EXPECT_EQ(text->data.get("action"), "refresh_item_data");
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "packet/game/server.hpp"
+#include "packet/generic_packets.hpp"
+
+using namespace packet;
+
+namespace {
+PacketVariant make_send_to_server()
+{
+    return PacketVariant{
+        std::string{ "OnSendToServer" },
+        int32_t{ 17091 },
+        int32_t{ 1234 },
+        int32_t{ 5678 },
+        std::string{ "127.0.0.1|door|uuid" },
+        uint32_t{ 1 },
+        std::string{ "growid" }
+    };
+}
+
+VariantPayload decode(const utils::SharedBytes& data)
+{
+    PacketVariantView view{};
+    EXPECT_TRUE(view.deserialize(data));
+    return VariantPayload{ GameUpdatePacket{}, view, data };
+}
+
+bool points_into(const std::string_view str, const utils::SharedBytes& data)
+{
+    const auto* begin{ reinterpret_cast<const char*>(data.data()) };
+    return str.data() >= begin && str.data() + str.size() <= begin + data.size();
+}
+}
+
+TEST(VariantPacketTest, ReadsFieldsFromTheReceivedBuffer)
+{
+    const utils::SharedBytes data{ make_send_to_server().serialize() };
+
+    game::OnSendToServer packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+
+    EXPECT_EQ(packet.port, 17091);
+    EXPECT_EQ(packet.token, 1234);
+    EXPECT_EQ(packet.user, 5678);
+    EXPECT_EQ(packet.address, "127.0.0.1");
+    EXPECT_EQ(packet.door_id, "door");
+    EXPECT_EQ(packet.uuid_token, "uuid");
+    EXPECT_EQ(packet.login_mode, 1);
+    EXPECT_EQ(packet.username, "growid");
+
+    // No owning variant was built, the arguments still point into the packet
+    EXPECT_TRUE(points_into(packet.argument(0), data));
+}
+
+TEST(VariantPacketTest, BuildsTheVariantOnFirstUse)
+{
+    const utils::SharedBytes data{ make_send_to_server().serialize() };
+
+    game::OnSendToServer packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+
+    auto& variant{ packet.variant() };
+    EXPECT_EQ(variant.serialize(), data.to_vector());
+    EXPECT_FALSE(points_into(packet.argument(0), data));
+
+    variant.set(2, int32_t{ 42 });
+    EXPECT_EQ(packet.argument<int32_t>(2), 42);
+}
+
+TEST(VariantPacketTest, ReadsOwningPayloads)
+{
+    game::OnSendToServer packet{};
+    ASSERT_TRUE(packet.read(VariantPayload{ GameUpdatePacket{}, make_send_to_server() }));
+
+    EXPECT_EQ(packet.port, 17091);
+    EXPECT_EQ(packet.address, "127.0.0.1");
+    EXPECT_EQ(packet.username, "growid");
+}
+
+TEST(VariantPacketTest, RejectsTooFewArguments)
+{
+    const utils::SharedBytes data{ PacketVariant{ std::string{ "OnSendToServer" }, int32_t{ 17091 } }.serialize() };
+
+    game::OnSendToServer packet{};
+    EXPECT_FALSE(packet.read(decode(data)));
+}
+
+TEST(VariantPacketTest, GenericPacketWritesItsArguments)
+{
+    const utils::SharedBytes data{ make_send_to_server().serialize() };
+
+    GenericVariantPacket packet{};
+    ASSERT_TRUE(packet.read(decode(data)));
+
+    const auto payload{ packet.write() };
+    const auto* var{ get_payload_if<VariantPayload>(payload) };
+    ASSERT_NE(var, nullptr);
+    EXPECT_EQ(var->variant.serialize(), data.to_vector());
+}
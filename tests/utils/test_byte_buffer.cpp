@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "utils/byte_buffer.hpp"
+
+using namespace utils;
+
+TEST(ByteBufferTest, ReadsLittleEndianValues)
+{
+    const auto buffer{ ByteBuffer::from_string(std::string{ "\x04\x00\x00\x00\x2a\x01", 6 }) };
+
+    EXPECT_EQ(buffer.read<std::uint32_t>(0), 4u);
+    EXPECT_EQ(buffer.read<std::uint16_t>(4), 0x012au);
+    EXPECT_EQ(buffer.read<std::uint8_t>(5), 1u);
+    EXPECT_FALSE(buffer.read<std::uint32_t>(3).has_value());
+    EXPECT_EQ(buffer.str(4, 2), std::string("\x2a\x01", 2));
+    EXPECT_FALSE(buffer.str(5, 2).has_value());
+}
+
+TEST(ByteBufferTest, SliceSharesWithoutCopy)
+{
+    const auto shared{ SharedBytes{ std::vector<std::byte>(8, std::byte{ 7 }) } };
+    const ByteBuffer buffer{ shared };
+
+    const auto slice{ buffer.slice(2, 4) };
+    ASSERT_TRUE(slice.has_value());
+    EXPECT_EQ(slice->size(), 4u);
+    EXPECT_EQ(slice->span().data(), shared.data() + 2);
+    EXPECT_EQ(buffer.slice(6)->size(), 2u);
+    EXPECT_FALSE(buffer.slice(6, 4).has_value());
+}
+
+TEST(ByteBufferTest, WriteCopiesSharedBytes)
+{
+    const auto shared{ SharedBytes{ std::vector<std::byte>(4) } };
+    ByteBuffer buffer{ shared };
+    const ByteBuffer copy{ buffer };
+
+    ASSERT_TRUE(buffer.write<std::uint16_t>(1, 0xbeef));
+    EXPECT_EQ(buffer.read<std::uint16_t>(1), 0xbeefu);
+    EXPECT_EQ(shared[1], std::byte{ 0 });
+    EXPECT_EQ(copy.read<std::uint16_t>(1), 0u);
+    EXPECT_FALSE(buffer.write<std::uint32_t>(2, 0));
+
+    // Already owned and not shared, written in place
+    const auto* data{ buffer.span().data() };
+    ASSERT_TRUE(buffer.write<std::uint8_t>(0, 1));
+    EXPECT_EQ(buffer.span().data(), data);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "utils/mpsc_queue.hpp"
+
+using namespace utils;
+
+TEST(MpscQueueTest, PopsInPushOrder)
+{
+    MpscQueue<int> queue{};
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop().has_value());
+
+    for (int i{ 0 }; i < 10; ++i) {
+        queue.push(i);
+    }
+
+    EXPECT_FALSE(queue.empty());
+    for (int i{ 0 }; i < 10; ++i) {
+        const auto value{ queue.pop() };
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(*value, i);
+    }
+
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, KeepsPerProducerOrder)
+{
+    constexpr int PRODUCERS{ 4 };
+    constexpr int ITEMS{ 10000 };
+
+    MpscQueue<std::pair<int, int>> queue{};
+    std::vector<std::thread> producers{};
+    for (int p{ 0 }; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i{ 0 }; i < ITEMS; ++i) {
+                queue.push({ p, i });
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received{ 0 };
+    while (received < PRODUCERS * ITEMS) {
+        const auto item{ queue.pop() };
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto [producer, index]{ *item };
+        EXPECT_EQ(index, next[producer]);
+        next[producer] = index + 1;
+        ++received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, DestroysRemainingItems)
+{
+    const auto item{ std::make_shared<int>(1) };
+    {
+        MpscQueue<std::shared_ptr<int>> queue{};
+        queue.push(item);
+        queue.push(item);
+        EXPECT_EQ(item.use_count(), 3);
+    }
+
+    EXPECT_EQ(item.use_count(), 1);
+}
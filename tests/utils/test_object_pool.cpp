@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "utils/object_pool.hpp"
+
+using namespace utils;
+
+namespace {
+struct Pooled {
+    int value;
+    explicit Pooled(const int v) : value{ v } { }
+};
+}
+
+TEST(ObjectPoolTest, ReusesReleasedBlock)
+{
+    const void* first{ nullptr };
+    {
+        const auto object{ make_pooled<Pooled>(1) };
+        first = object.get();
+    }
+
+    const auto object{ make_pooled<Pooled>(2) };
+    EXPECT_EQ(object.get(), first);
+    EXPECT_EQ(object->value, 2);
+}
+
+TEST(ObjectPoolTest, RetainedObjectIsNotRecycled)
+{
+    auto retained{ make_pooled<Pooled>(1) };
+    const auto other{ make_pooled<Pooled>(2) };
+
+    EXPECT_NE(retained.get(), other.get());
+    EXPECT_EQ(retained->value, 1);
+
+    const auto* address{ retained.get() };
+    retained.reset();
+
+    const auto reused{ make_pooled<Pooled>(3) };
+    EXPECT_EQ(reused.get(), address);
+}
+
+TEST(ObjectPoolTest, SupportsSharedFromThis)
+{
+    struct Node : std::enable_shared_from_this<Node> { };
+
+    const auto node{ make_pooled<Node>() };
+    EXPECT_EQ(node->shared_from_this(), node);
+}
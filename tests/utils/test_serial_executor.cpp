@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "utils/serial_executor.hpp"
+
+using namespace utils;
+
+TEST(SerialExecutorTest, RunsTasksInPostOrder)
+{
+    std::vector<int> order{};
+    {
+        SerialExecutor executor{};
+        for (int i{ 0 }; i < 100; ++i) {
+            executor.post([&order, i] { order.push_back(i); });
+        }
+    }
+
+    ASSERT_EQ(order.size(), 100u);
+    for (int i{ 0 }; i < 100; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(SerialExecutorTest, RunsOffTheCallingThread)
+{
+    SerialExecutor executor{};
+    std::thread::id task_thread{};
+
+    executor.post([&task_thread] { task_thread = std::this_thread::get_id(); });
+    executor.wait_idle();
+
+    EXPECT_NE(task_thread, std::thread::id{});
+    EXPECT_NE(task_thread, std::this_thread::get_id());
+}
+
+TEST(SerialExecutorTest, WaitIdleWaitsForRunningTask)
+{
+    SerialExecutor executor{};
+    std::atomic<bool> started{ false };
+    std::atomic<bool> finished{ false };
+
+    executor.post([&] {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+        finished = true;
+    });
+
+    while (!started) {
+        std::this_thread::yield();
+    }
+
+    executor.wait_idle();
+    EXPECT_TRUE(finished);
+}
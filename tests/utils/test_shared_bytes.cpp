@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "utils/shared_bytes.hpp"
+
+using namespace utils;
+
+TEST(SharedBytesTest, TakesOwnershipOfVector)
+{
+    std::vector<std::byte> bytes{ std::byte{ 1 }, std::byte{ 2 }, std::byte{ 3 } };
+    const auto* data{ bytes.data() };
+
+    const SharedBytes shared{ std::move(bytes) };
+    EXPECT_EQ(shared.size(), 3);
+    EXPECT_EQ(shared.data(), data);
+    EXPECT_EQ(shared[2], std::byte{ 3 });
+}
+
+TEST(SharedBytesTest, SubspanSharesOwner)
+{
+    const auto shared{ SharedBytes::copy_of(std::vector<std::byte>(8, std::byte{ 7 })) };
+    const auto tail{ shared.subspan(4) };
+
+    EXPECT_EQ(tail.size(), 4);
+    EXPECT_EQ(tail.data(), shared.data() + 4);
+    EXPECT_EQ(shared.use_count(), 2);
+}
+
+TEST(SharedBytesTest, ReleasesOwnerWithLastCopy)
+{
+    bool released{ false };
+    {
+        static constexpr std::byte buffer[4]{};
+        const std::shared_ptr<const void> owner{ buffer, [&released](const void*) { released = true; } };
+
+        SharedBytes copy{};
+        {
+            const SharedBytes shared{ owner, buffer };
+            copy = shared.subspan(1, 2);
+        }
+
+        EXPECT_FALSE(released);
+        EXPECT_EQ(copy.size(), 2);
+    }
+
+    EXPECT_TRUE(released);
+}
+
+TEST(SharedBytesTest, DefaultIsEmpty)
+{
+    const SharedBytes shared{};
+    EXPECT_TRUE(shared.empty());
+    EXPECT_TRUE(shared.to_vector().empty());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "utils/text_parse_view.hpp"
+
+using namespace utils;
+
+TEST(TextParseViewTest, ParseStringWithDefaultDelimiter)
+{
+    const std::string text{ "key1|value1|value2\nkey2|value3" };
+    const TextParseView tpv{ text };
+
+    EXPECT_EQ(tpv.get("key1", 0), "value1");
+    EXPECT_EQ(tpv.get("key1", 1), "value2");
+    EXPECT_EQ(tpv.get("key2", 0), "value3");
+    EXPECT_EQ(tpv.get("nonexistent", 0), "");
+    EXPECT_EQ(tpv.size(), 2);
+}
+
+TEST(TextParseViewTest, ViewsPointIntoSource)
+{
+    const std::string text{ "action|input\n|text|hello" };
+    const TextParseView tpv{ text };
+
+    const auto value{ tpv.get<std::string_view>("text", 0) };
+    EXPECT_EQ(value, "hello");
+    EXPECT_GE(value.data(), text.data());
+    EXPECT_LT(value.data(), text.data() + text.size());
+}
+
+TEST(TextParseViewTest, GetTypedValues)
+{
+    const TextParseView tpv{ "int|123\nfloat|123.456\nstring|hello" };
+
+    EXPECT_EQ(tpv.get<int>("int", 0), 123);
+    EXPECT_NEAR(tpv.get<float>("float", 0), 123.456f, 0.001f);
+    EXPECT_EQ(tpv.get("string", 0), "hello");
+    EXPECT_EQ(tpv.get<int>("nonexistent", 0), 0);
+    EXPECT_EQ(tpv.get<int>("int", 5), 0);
+}
+
+TEST(TextParseViewTest, MatchesTextParse)
+{
+    const std::string text{ "213.179.209.175||-1\n\nno_delimiter\n||key|a||b|\nkey2|" };
+    const TextParse tp{ text };
+    const TextParseView tpv{ text };
+
+    ASSERT_EQ(tpv.size(), tp.get_data().size());
+
+    const auto data{ tpv.get_data() };
+    for (std::size_t i{ 0 }; i < data.size(); ++i) {
+        const auto& [key, values] = tp.get_data()[i];
+        EXPECT_EQ(data[i].first, key);
+        ASSERT_EQ(data[i].second.size(), values.size());
+
+        for (std::size_t j{ 0 }; j < values.size(); ++j) {
+            EXPECT_EQ(data[i].second[j], values[j]);
+        }
+    }
+}
+
+TEST(TextParseViewTest, ToOwned)
+{
+    const TextParseView tpv{ "server|1.2.3.4\nport|17091" };
+
+    TextParse tp{ tpv.to_owned() };
+    EXPECT_EQ(tp.get("server", 0), "1.2.3.4");
+    EXPECT_EQ(tp.get<int>("port", 0), 17091);
+
+    tp.set("server", { "127.0.0.1" });
+    EXPECT_EQ(tp.get_raw(), "server|127.0.0.1\nport|17091");
+}